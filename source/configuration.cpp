@@ -18,59 +18,115 @@
  */
 
 #include "configuration.hpp"
+#include <fstream>
 #include "obs/obs-tools.hpp"
 #include "plugin.hpp"
 
+#define LOCAL_PREFIX "<configuration> "
+
 constexpr std::string_view version_tag_name = "Version";
 constexpr std::string_view path_backup_ext  = ".bk";
+constexpr std::string_view path_temp_ext    = ".tmp";
+
+// Wait for changes to settle for this long before writing, but never longer than the maximum.
+constexpr std::chrono::milliseconds save_delay{1000};
+constexpr std::chrono::milliseconds save_delay_maximum{5000};
 
 streamfx::configuration::~configuration()
 {
-	// Update version tag.
-	obs_data_set_int(_data.get(), version_tag_name.data(), STREAMFX_VERSION);
+	{
+		auto lock = lock_loaded();
 
-	try {
-		if (_config_path.has_parent_path()) {
-			std::filesystem::create_directories(_config_path.parent_path());
-		}
-		if (!obs_data_save_json_safe(_data.get(), _config_path.u8string().c_str(), ".tmp", path_backup_ext.data())) {
-			throw std::exception();
-		}
-	} catch (std::exception const& ex) {
-		DLOG_ERROR("Failed to save configuration: %s", ex.what());
+		// Update version tag, and always save once more on exit.
+		obs_data_set_int(_data.get(), version_tag_name.data(), STREAMFX_VERSION);
+		_dirty = true;
+		_exit  = true;
+	}
+	_cv.notify_all();
+
+	if (_worker.joinable()) {
+		_worker.join();
 	}
 }
 
-streamfx::configuration::configuration() : _data(), _config_path()
+streamfx::configuration::configuration()
+	: _config_path(), _lock(), _cv(), _data(), _loaded(false), _dirty(false), _exit(false), _dirty_since(),
+	  _dirty_last(), _worker()
 {
 	// Retrieve global configuration path.
 	_config_path = streamfx::config_file_path("config.json");
 
-	try {
-		if (!std::filesystem::exists(_config_path) || !std::filesystem::is_regular_file(_config_path)) {
-			throw std::runtime_error("Configuration does not exist.");
-		} else {
-			obs_data_t* data =
-				obs_data_create_from_json_file_safe(_config_path.u8string().c_str(), path_backup_ext.data());
-			if (!data) {
-				throw std::runtime_error("Failed to load configuration from disk.");
-			} else {
-				_data = std::shared_ptr<obs_data_t>(data, obs::obs_data_deleter);
-			}
-		}
-	} catch (...) {
-		_data = std::shared_ptr<obs_data_t>(obs_data_create(), obs::obs_data_deleter);
-	}
+	// Loading and saving both happen on our own thread, so that the thread creating us never waits on the disk.
+	_worker = std::thread(&configuration::worker, this);
 }
 
 std::shared_ptr<obs_data_t> streamfx::configuration::get()
 {
+	auto lock = lock_loaded();
 	obs_data_addref(_data.get());
 	return std::shared_ptr<obs_data_t>(_data.get(), obs::obs_data_deleter);
 }
 
+bool streamfx::configuration::has(std::string_view key)
+{
+	auto lock = lock_loaded();
+	return obs_data_has_user_value(_data.get(), key.data());
+}
+
+bool streamfx::configuration::get_bool(std::string_view key, bool default_value)
+{
+	auto lock = lock_loaded();
+	if (!obs_data_has_user_value(_data.get(), key.data()))
+		return default_value;
+	return obs_data_get_bool(_data.get(), key.data());
+}
+
+void streamfx::configuration::set_bool(std::string_view key, bool value)
+{
+	auto lock = lock_loaded();
+	if (obs_data_has_user_value(_data.get(), key.data()) && (obs_data_get_bool(_data.get(), key.data()) == value))
+		return;
+	obs_data_set_bool(_data.get(), key.data(), value);
+	mark_dirty();
+}
+
+int64_t streamfx::configuration::get_integer(std::string_view key, int64_t default_value)
+{
+	auto lock = lock_loaded();
+	if (!obs_data_has_user_value(_data.get(), key.data()))
+		return default_value;
+	return obs_data_get_int(_data.get(), key.data());
+}
+
+void streamfx::configuration::set_integer(std::string_view key, int64_t value)
+{
+	auto lock = lock_loaded();
+	if (obs_data_has_user_value(_data.get(), key.data()) && (obs_data_get_int(_data.get(), key.data()) == value))
+		return;
+	obs_data_set_int(_data.get(), key.data(), value);
+	mark_dirty();
+}
+
+std::string streamfx::configuration::get_string(std::string_view key, std::string_view default_value)
+{
+	auto lock = lock_loaded();
+	if (!obs_data_has_user_value(_data.get(), key.data()))
+		return std::string(default_value);
+	return obs_data_get_string(_data.get(), key.data());
+}
+
+void streamfx::configuration::set_string(std::string_view key, std::string_view value)
+{
+	auto lock = lock_loaded();
+	if (obs_data_has_user_value(_data.get(), key.data()) && (value == obs_data_get_string(_data.get(), key.data())))
+		return;
+	obs_data_set_string(_data.get(), key.data(), value.data());
+	mark_dirty();
+}
+
 uint64_t streamfx::configuration::version()
 {
+	auto lock = lock_loaded();
 	return static_cast<uint64_t>(obs_data_get_int(_data.get(), version_tag_name.data()));
 }
 
@@ -79,6 +135,115 @@ bool streamfx::configuration::is_different_version()
 	return (version() & STREAMFX_MASK_COMPAT) != (STREAMFX_VERSION & STREAMFX_MASK_COMPAT);
 }
 
+std::unique_lock<std::mutex> streamfx::configuration::lock_loaded()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	_cv.wait(lock, [this]() { return _loaded; });
+	return lock;
+}
+
+void streamfx::configuration::mark_dirty()
+{
+	auto now = std::chrono::steady_clock::now();
+	if (!_dirty) {
+		_dirty       = true;
+		_dirty_since = now;
+	}
+	_dirty_last = now;
+	_cv.notify_all();
+}
+
+void streamfx::configuration::worker()
+{
+	read();
+
+	std::unique_lock<std::mutex> lock(_lock);
+	while (true) {
+		_cv.wait(lock, [this]() { return _dirty || _exit; });
+
+		// Give further changes a chance to arrive, so that a burst of them results in a single write.
+		while (!_exit) {
+			auto deadline = std::min(_dirty_last + save_delay, _dirty_since + save_delay_maximum);
+			if (std::chrono::steady_clock::now() >= deadline) {
+				break;
+			}
+			_cv.wait_until(lock, deadline);
+		}
+
+		if (_dirty) {
+			std::string json = obs_data_get_json(_data.get());
+			_dirty           = false;
+
+			lock.unlock();
+			try {
+				write(json);
+			} catch (std::exception const& ex) {
+				DLOG_ERROR(LOCAL_PREFIX "Failed to save configuration: %s", ex.what());
+			}
+			lock.lock();
+		}
+
+		if (_exit && !_dirty) {
+			break;
+		}
+	}
+}
+
+void streamfx::configuration::read()
+{
+	std::shared_ptr<obs_data_t> data;
+	try {
+		if (!std::filesystem::exists(_config_path) || !std::filesystem::is_regular_file(_config_path)) {
+			throw std::runtime_error("Configuration does not exist.");
+		} else {
+			obs_data_t* raw =
+				obs_data_create_from_json_file_safe(_config_path.u8string().c_str(), path_backup_ext.data());
+			if (!raw) {
+				throw std::runtime_error("Failed to load configuration from disk.");
+			} else {
+				data = std::shared_ptr<obs_data_t>(raw, obs::obs_data_deleter);
+			}
+		}
+	} catch (...) {
+		data = std::shared_ptr<obs_data_t>(obs_data_create(), obs::obs_data_deleter);
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		_data   = data;
+		_loaded = true;
+	}
+	_cv.notify_all();
+}
+
+void streamfx::configuration::write(const std::string& json)
+{
+	std::filesystem::path path_temp = _config_path;
+	path_temp += path_temp_ext;
+	std::filesystem::path path_backup = _config_path;
+	path_backup += path_backup_ext;
+
+	if (_config_path.has_parent_path()) {
+		std::filesystem::create_directories(_config_path.parent_path());
+	}
+
+	// Write everything to a temporary file first, so that a crash mid-write never leaves a broken configuration.
+	{
+		std::ofstream file(path_temp, std::ios::binary | std::ios::trunc);
+		file.write(json.data(), static_cast<std::streamsize>(json.size()));
+		file.close();
+		if (file.fail()) {
+			throw std::runtime_error("Failed to write temporary file.");
+		}
+	}
+
+	// Keep the previous configuration as a backup, then move the new one in place.
+	if (std::filesystem::exists(_config_path)) {
+		std::filesystem::rename(_config_path, path_backup);
+	}
+	std::filesystem::rename(path_temp, _config_path);
+}
+
 static std::shared_ptr<streamfx::configuration> _instance = nullptr;
 
 void streamfx::configuration::initialize()
@@ -19,26 +19,68 @@
 
 #pragma once
 #include "common.hpp"
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
 
 namespace streamfx {
+	/** Global configuration, loaded and saved on a background thread.
+	 *
+	 * Changes made through the typed accessors mark the configuration as dirty, and are written to disk in one go
+	 * once no further changes have happened for a short while.
+	 */
 	class configuration {
-		std::shared_ptr<obs_data_t> _data;
-
 		std::filesystem::path _config_path;
 
+		std::mutex                            _lock;
+		std::condition_variable               _cv;
+		std::shared_ptr<obs_data_t>           _data;
+		bool                                  _loaded;
+		bool                                  _dirty;
+		bool                                  _exit;
+		std::chrono::steady_clock::time_point _dirty_since;
+		std::chrono::steady_clock::time_point _dirty_last;
+		std::thread                           _worker;
+
 		public:
 		~configuration();
 		configuration();
 
 		public:
+		/** Raw access to the data, changes made through this are only saved on exit. */
 		std::shared_ptr<obs_data_t> get();
 
+		bool has(std::string_view key);
+
+		bool get_bool(std::string_view key, bool default_value = false);
+		void set_bool(std::string_view key, bool value);
+
+		int64_t get_integer(std::string_view key, int64_t default_value = 0);
+		void    set_integer(std::string_view key, int64_t value);
+
+		std::string get_string(std::string_view key, std::string_view default_value = "");
+		void        set_string(std::string_view key, std::string_view value);
+
 		uint64_t version();
 
 		bool is_different_version();
 
+		private:
+		std::unique_lock<std::mutex> lock_loaded();
+
+		void mark_dirty();
+
+		void worker();
+
+		void read();
+
+		void write(const std::string& json);
+
 		public /* Singleton */:
 		static void                                     initialize();
 		static void                                     finalize();
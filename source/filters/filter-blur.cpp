@@ -29,6 +29,7 @@
 #include "gfx/blur/gfx-blur-dual-filtering.hpp"
 #include "gfx/blur/gfx-blur-gaussian-linear.hpp"
 #include "gfx/blur/gfx-blur-gaussian.hpp"
+#include "gfx/gfx-effect-registry.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "obs/obs-source-tracker.hpp"
 
@@ -115,7 +116,7 @@ blur_instance::blur_instance(obs_data_t* settings, obs_source_t* self)
 		{
 			auto file = streamfx::data_file_path("effects/mask.effect").string();
 			try {
-				_effect_mask = gs::effect::create(file);
+				_effect_mask = gfx::effect_registry::get()->load(file);
 			} catch (std::runtime_error& ex) {
 				DLOG_ERROR("<filter-blur> Loading effect '%s' failed with error(s): %s", file.c_str(), ex.what());
 			}
@@ -325,12 +326,18 @@ void blur_instance::video_tick(float)
 	// Load Mask
 	if (_mask.type == mask_type::Image) {
 		if (_mask.image.path_old != _mask.image.path) {
-			try {
-				_mask.image.texture  = std::make_shared<gs::texture>(_mask.image.path);
-				_mask.image.path_old = _mask.image.path;
-			} catch (...) {
+			// Keep the current texture until the new one has been loaded.
+			_mask.image.request  = gfx::texture_loader::get()->load(_mask.image.path);
+			_mask.image.path_old = _mask.image.path;
+		}
+		if (_mask.image.request) {
+			if (_mask.image.request->is_ready()) {
+				_mask.image.texture = _mask.image.request->get_texture();
+				_mask.image.request.reset();
+			} else if (_mask.image.request->has_failed()) {
 				DLOG_ERROR("<filter-blur> Instance '%s' failed to load image '%s'.", obs_source_get_name(_self),
 						   _mask.image.path.c_str());
+				_mask.image.request.reset();
 			}
 		}
 	} else if (_mask.type == mask_type::Source) {
@@ -869,13 +876,13 @@ obs_properties_t* blur_factory::get_properties2(blur_instance* data)
 				obs_property_list_add_string(p, std::string(name + " (Source)").c_str(), name.c_str());
 				return false;
 			},
-			obs::source_tracker::filter_video_sources);
+			obs::source_tracker::index::VideoSources);
 		obs::source_tracker::get()->enumerate(
 			[&p](std::string name, obs_source_t*) {
 				obs_property_list_add_string(p, std::string(name + " (Scene)").c_str(), name.c_str());
 				return false;
 			},
-			obs::source_tracker::filter_scenes);
+			obs::source_tracker::index::Scenes);
 
 		/// Shared
 		p = obs_properties_add_color(pr, ST_MASK_COLOR, D_TRANSLATE(ST_MASK_COLOR));
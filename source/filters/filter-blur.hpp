@@ -25,6 +25,7 @@
 #include <map>
 #include "gfx/blur/gfx-blur-base.hpp"
 #include "gfx/gfx-source-texture.hpp"
+#include "gfx/gfx-texture-loader.hpp"
 #include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
@@ -74,9 +75,10 @@ namespace streamfx::filter::blur {
 				bool    invert;
 			} region;
 			struct {
-				std::string                  path;
-				std::string                  path_old;
-				std::shared_ptr<gs::texture> texture;
+				std::string                           path;
+				std::string                           path_old;
+				std::shared_ptr<gfx::texture_request> request;
+				std::shared_ptr<gs::texture>          texture;
 			} image;
 			struct {
 				std::string                          name_old;
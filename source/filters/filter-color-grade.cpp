@@ -20,6 +20,7 @@
 #include "filter-color-grade.hpp"
 #include "strings.hpp"
 #include <stdexcept>
+#include "gfx/gfx-effect-registry.hpp"
 #include "obs/gs/gs-helper.hpp"
 
 // OBS
@@ -83,7 +84,7 @@ color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self)
 	{
 		auto file = streamfx::data_file_path("effects/color-grade.effect").u8string();
 		try {
-			_effect = gs::effect::create(file);
+			_effect = gfx::effect_registry::get()->load(file);
 		} catch (std::runtime_error& ex) {
 			DLOG_ERROR("<filter-color-grade> Loading effect '%s' failed with error(s): %s", file.c_str(), ex.what());
 			throw;
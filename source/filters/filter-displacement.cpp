@@ -21,6 +21,7 @@
 #include "strings.hpp"
 #include <stdexcept>
 #include <sys/stat.h>
+#include "gfx/gfx-effect-registry.hpp"
 #include "obs/gs/gs-helper.hpp"
 
 #define ST "Filter.Displacement"
@@ -33,13 +34,14 @@ using namespace streamfx::filter::displacement;
 displacement_instance::displacement_instance(obs_data_t* data, obs_source_t* context)
 	: obs::source_instance(data, context)
 {
-	_effect = gs::effect::create(streamfx::data_file_path("effects/displace.effect").u8string());
+	_effect = gfx::effect_registry::get()->load(streamfx::data_file_path("effects/displace.effect"));
 
 	update(data);
 }
 
 displacement_instance::~displacement_instance()
 {
+	_texture_request.reset();
 	_texture.reset();
 }
 
@@ -67,17 +69,30 @@ void displacement_instance::update(obs_data_t* settings)
 
 	std::string new_file = obs_data_get_string(settings, ST_FILE);
 	if (new_file != _texture_file) {
-		try {
-			_texture      = std::make_shared<gs::texture>(new_file);
-			_texture_file = new_file;
-		} catch (...) {
+		if (new_file.empty()) {
+			// Nothing to load, so there is nothing to wait for either.
 			_texture.reset();
+			_texture_request.reset();
+		} else {
+			// Keep the current texture until the new one has been loaded.
+			_texture_request = gfx::texture_loader::get()->load(new_file);
 		}
+		_texture_file = new_file;
 	}
 }
 
 void displacement_instance::video_tick(float_t)
 {
+	if (_texture_request) {
+		if (_texture_request->is_ready()) {
+			_texture = _texture_request->get_texture();
+			_texture_request.reset();
+		} else if (_texture_request->has_failed()) {
+			_texture.reset();
+			_texture_request.reset();
+		}
+	}
+
 	_width  = obs_source_get_base_width(_self);
 	_height = obs_source_get_base_height(_self);
 }
@@ -19,6 +19,7 @@
 
 #pragma once
 #include "common.hpp"
+#include "gfx/gfx-texture-loader.hpp"
 #include "obs/gs/gs-effect.hpp"
 #include "obs/obs-source-factory.hpp"
 
@@ -27,10 +28,11 @@ namespace streamfx::filter::displacement {
 		gs::effect _effect;
 
 		// Displacement Map
-		std::shared_ptr<gs::texture> _texture;
-		std::string                  _texture_file;
-		float_t                      _scale[2];
-		float_t                      _scale_type;
+		std::shared_ptr<gs::texture>          _texture;
+		std::shared_ptr<gfx::texture_request> _texture_request;
+		std::string                           _texture_file;
+		float_t                               _scale[2];
+		float_t                               _scale_type;
 
 		// Cache
 		uint32_t _width;
@@ -22,6 +22,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <vector>
+#include "gfx/gfx-effect-registry.hpp"
 #include "obs/gs/gs-helper.hpp"
 
 // Filter to allow dynamic masking
@@ -59,7 +60,7 @@ dynamic_mask_instance::dynamic_mask_instance(obs_data_t* settings, obs_source_t*
 	_final_rt  = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 
 	try {
-		_effect = gs::effect::create(streamfx::data_file_path("effects/channel-mask.effect").u8string());
+		_effect = gfx::effect_registry::get()->load(streamfx::data_file_path("effects/channel-mask.effect"));
 	} catch (const std::exception& ex) {
 		DLOG_ERROR("Loading channel mask effect failed with error(s):\n%s", ex.what());
 	}
@@ -443,7 +444,7 @@ obs_properties_t* dynamic_mask_factory::get_properties2(dynamic_mask_instance* d
 				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
 				return false;
 			},
-			obs::source_tracker::filter_video_sources);
+			obs::source_tracker::index::VideoSources);
 		obs::source_tracker::get()->enumerate(
 			[&p](std::string name, obs_source_t*) {
 				std::stringstream sstr;
@@ -451,7 +452,7 @@ obs_properties_t* dynamic_mask_factory::get_properties2(dynamic_mask_instance* d
 				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
 				return false;
 			},
-			obs::source_tracker::filter_scenes);
+			obs::source_tracker::index::Scenes);
 	}
 
 	const char* pri_chs[] = {S_CHANNEL_RED, S_CHANNEL_GREEN, S_CHANNEL_BLUE, S_CHANNEL_ALPHA};
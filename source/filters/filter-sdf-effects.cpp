@@ -20,6 +20,7 @@
 #include "filter-sdf-effects.hpp"
 #include "strings.hpp"
 #include <stdexcept>
+#include "gfx/gfx-effect-registry.hpp"
 #include "obs/gs/gs-helper.hpp"
 
 #define LOG_PREFIX "<filter-sdf-effects> "
@@ -68,7 +69,7 @@
 using namespace streamfx::filter::sdf_effects;
 
 sdf_effects_instance::sdf_effects_instance(obs_data_t* settings, obs_source_t* self)
-	: obs::source_instance(settings, self), _source_rendered(false), _sdf_scale(1.0), _sdf_threshold(),
+	: obs::source_instance(settings, self), _source_rendered(false), _dirty(true), _sdf_scale(1.0), _sdf_threshold(),
 	  _output_rendered(false), _inner_shadow(false), _inner_shadow_color(), _inner_shadow_range_min(),
 	  _inner_shadow_range_max(), _inner_shadow_offset_x(), _inner_shadow_offset_y(), _outer_shadow(false),
 	  _outer_shadow_color(), _outer_shadow_range_min(), _outer_shadow_range_max(), _outer_shadow_offset_x(),
@@ -82,29 +83,58 @@ sdf_effects_instance::sdf_effects_instance(obs_data_t* settings, obs_source_t* s
 		vec4 transparent = {0, 0, 0, 0};
 
 		_source_rt = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-		_sdf_write = std::make_shared<gs::rendertarget>(GS_RGBA32F, GS_ZS_NONE);
-		_sdf_read  = std::make_shared<gs::rendertarget>(GS_RGBA32F, GS_ZS_NONE);
 		_output_rt = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 
-		std::shared_ptr<gs::rendertarget> initialize_rts[] = {_source_rt, _sdf_write, _sdf_read, _output_rt};
+		std::shared_ptr<gs::rendertarget> initialize_rts[] = {_source_rt, _output_rt};
 		for (auto rt : initialize_rts) {
 			auto op = rt->render(1, 1);
 			gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &transparent, 0, 0);
 		}
 
 		std::pair<const char*, gs::effect&> load_arr[] = {
-			{"effects/sdf/sdf-producer.effect", _sdf_producer_effect},
 			{"effects/sdf/sdf-consumer.effect", _sdf_consumer_effect},
 		};
 		for (auto& kv : load_arr) {
 			auto path = streamfx::data_file_path(kv.first).u8string();
 			try {
-				kv.second = gs::effect::create(path);
+				kv.second = gfx::effect_registry::get()->load(path);
 			} catch (const std::exception& ex) {
 				DLOG_ERROR(LOG_PREFIX "Failed to load effect '%s' (located at '%s') with error(s): %s", kv.first,
 						   path.c_str(), ex.what());
 			}
 		}
+
+		if (_sdf_consumer_effect) {
+			_consumer.sdf_texture           = _sdf_consumer_effect.get_parameter("pSDFTexture");
+			_consumer.sdf_threshold         = _sdf_consumer_effect.get_parameter("pSDFThreshold");
+			_consumer.image_texture         = _sdf_consumer_effect.get_parameter("pImageTexture");
+			_consumer.shadow_color          = _sdf_consumer_effect.get_parameter("pShadowColor");
+			_consumer.shadow_min            = _sdf_consumer_effect.get_parameter("pShadowMin");
+			_consumer.shadow_max            = _sdf_consumer_effect.get_parameter("pShadowMax");
+			_consumer.shadow_offset         = _sdf_consumer_effect.get_parameter("pShadowOffset");
+			_consumer.glow_color            = _sdf_consumer_effect.get_parameter("pGlowColor");
+			_consumer.glow_width            = _sdf_consumer_effect.get_parameter("pGlowWidth");
+			_consumer.glow_sharpness        = _sdf_consumer_effect.get_parameter("pGlowSharpness");
+			_consumer.glow_sharpness_inv    = _sdf_consumer_effect.get_parameter("pGlowSharpnessInverse");
+			_consumer.outline_color         = _sdf_consumer_effect.get_parameter("pOutlineColor");
+			_consumer.outline_width         = _sdf_consumer_effect.get_parameter("pOutlineWidth");
+			_consumer.outline_offset        = _sdf_consumer_effect.get_parameter("pOutlineOffset");
+			_consumer.outline_sharpness     = _sdf_consumer_effect.get_parameter("pOutlineSharpness");
+			_consumer.outline_sharpness_inv = _sdf_consumer_effect.get_parameter("pOutlineSharpnessInverse");
+		}
+
+		try {
+			_sdf = std::make_shared<gfx::sdf_jump_flood>();
+		} catch (const std::exception& ex) {
+			DLOG_ERROR(LOG_PREFIX "Failed to create distance field generator: %s", ex.what());
+		}
+
+		try {
+			_change_detector = std::make_shared<gfx::change_detector>();
+		} catch (const std::exception& ex) {
+			DLOG_WARNING(LOG_PREFIX "Failed to create change detector, effects will be rendered every frame: %s",
+						 ex.what());
+		}
 	}
 
 	update(settings);
@@ -252,6 +282,8 @@ void sdf_effects_instance::update(obs_data_t* data)
 
 	_sdf_scale     = double_t(obs_data_get_double(data, ST_SDF_SCALE) / 100.0);
 	_sdf_threshold = float_t(obs_data_get_double(data, ST_SDF_THRESHOLD) / 100.0);
+
+	_dirty = true;
 }
 
 void sdf_effects_instance::video_tick(float_t)
@@ -283,6 +315,7 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 
 	auto gctx              = gs::context();
 	vec4 color_transparent = {0, 0, 0, 0};
+	bool dirty             = false;
 
 	try {
 		gs_blend_state_push();
@@ -321,15 +354,15 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 				throw std::runtime_error("failed to draw source");
 			}
 
-			// Generate SDF Buffers
-			{
-				_sdf_read->get_texture(_sdf_texture);
-				if (!_sdf_texture) {
-					throw std::runtime_error("SDF Backbuffer empty");
-				}
+			// Static sources (text, logos) rarely change, so only regenerate when the content actually did. The flag is
+			// cleared before regenerating, so a concurrent update() is picked up by the next frame instead of lost.
+			bool changed = !_change_detector || _change_detector->update(_source_texture);
+			dirty        = _dirty.exchange(false) || changed;
 
-				if (!_sdf_producer_effect) {
-					throw std::runtime_error("SDF Effect no loaded");
+			// Generate SDF Buffers
+			if (dirty) {
+				if (!_sdf) {
+					throw std::runtime_error("SDF Generator not loaded");
 				}
 
 				// Scale SDF Size
@@ -348,21 +381,8 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 					gs::debug_marker gdm{gs::debug_color_convert, "Update Distance Field"};
 #endif
 
-					auto op = _sdf_write->render(uint32_t(sdfW), uint32_t(sdfH));
-					gs_ortho(0, 1, 0, 1, -1, 1);
-					gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
-
-					_sdf_producer_effect.get_parameter("_image").set_texture(_source_texture);
-					_sdf_producer_effect.get_parameter("_size").set_float2(float_t(sdfW), float_t(sdfH));
-					_sdf_producer_effect.get_parameter("_sdf").set_texture(_sdf_texture);
-					_sdf_producer_effect.get_parameter("_threshold").set_float(_sdf_threshold);
-
-					while (gs_effect_loop(_sdf_producer_effect.get_object(), "Draw")) {
-						streamfx::gs_draw_fullscreen_tri();
-					}
+					_sdf_texture = _sdf->render(_source_texture, uint32_t(sdfW), uint32_t(sdfH), _sdf_threshold);
 				}
-				std::swap(_sdf_read, _sdf_write);
-				_sdf_read->get_texture(_sdf_texture);
 				if (!_sdf_texture) {
 					throw std::runtime_error("SDF Backbuffer empty");
 				}
@@ -374,14 +394,18 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 		gs_blend_state_pop();
 	} catch (...) {
 		gs_blend_state_pop();
+		if (dirty) {
+			_dirty = true;
+		}
 		obs_source_skip_video_filter(_self);
 		return;
 	}
 
-	if (!_output_rendered) {
+	if (!_output_rendered && dirty) {
 		_output_texture = _source_texture;
 
 		if (!_sdf_consumer_effect) {
+			_dirty = true;
 			obs_source_skip_video_filter(_self);
 			return;
 		}
@@ -422,64 +446,64 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 			gs_enable_blending(true);
 			gs_blend_function_separate(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA, GS_BLEND_ONE, GS_BLEND_ONE);
 			if (_outer_shadow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pShadowColor").set_float4(_outer_shadow_color);
-				_sdf_consumer_effect.get_parameter("pShadowMin").set_float(_outer_shadow_range_min);
-				_sdf_consumer_effect.get_parameter("pShadowMax").set_float(_outer_shadow_range_max);
-				_sdf_consumer_effect.get_parameter("pShadowOffset")
-					.set_float2(_outer_shadow_offset_x / float_t(baseW), _outer_shadow_offset_y / float_t(baseH));
+				_consumer.sdf_texture.set_texture(_sdf_texture);
+				_consumer.sdf_threshold.set_float(_sdf_threshold);
+				_consumer.image_texture.set_texture(_source_texture->get_object());
+				_consumer.shadow_color.set_float4(_outer_shadow_color);
+				_consumer.shadow_min.set_float(_outer_shadow_range_min);
+				_consumer.shadow_max.set_float(_outer_shadow_range_max);
+				_consumer.shadow_offset.set_float2(_outer_shadow_offset_x / float_t(baseW),
+												   _outer_shadow_offset_y / float_t(baseH));
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "ShadowOuter")) {
 					streamfx::gs_draw_fullscreen_tri();
 				}
 			}
 			if (_inner_shadow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pShadowColor").set_float4(_inner_shadow_color);
-				_sdf_consumer_effect.get_parameter("pShadowMin").set_float(_inner_shadow_range_min);
-				_sdf_consumer_effect.get_parameter("pShadowMax").set_float(_inner_shadow_range_max);
-				_sdf_consumer_effect.get_parameter("pShadowOffset")
-					.set_float2(_inner_shadow_offset_x / float_t(baseW), _inner_shadow_offset_y / float_t(baseH));
+				_consumer.sdf_texture.set_texture(_sdf_texture);
+				_consumer.sdf_threshold.set_float(_sdf_threshold);
+				_consumer.image_texture.set_texture(_source_texture->get_object());
+				_consumer.shadow_color.set_float4(_inner_shadow_color);
+				_consumer.shadow_min.set_float(_inner_shadow_range_min);
+				_consumer.shadow_max.set_float(_inner_shadow_range_max);
+				_consumer.shadow_offset.set_float2(_inner_shadow_offset_x / float_t(baseW),
+												   _inner_shadow_offset_y / float_t(baseH));
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "ShadowInner")) {
 					streamfx::gs_draw_fullscreen_tri();
 				}
 			}
 			if (_outer_glow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pGlowColor").set_float4(_outer_glow_color);
-				_sdf_consumer_effect.get_parameter("pGlowWidth").set_float(_outer_glow_width);
-				_sdf_consumer_effect.get_parameter("pGlowSharpness").set_float(_outer_glow_sharpness);
-				_sdf_consumer_effect.get_parameter("pGlowSharpnessInverse").set_float(_outer_glow_sharpness_inv);
+				_consumer.sdf_texture.set_texture(_sdf_texture);
+				_consumer.sdf_threshold.set_float(_sdf_threshold);
+				_consumer.image_texture.set_texture(_source_texture->get_object());
+				_consumer.glow_color.set_float4(_outer_glow_color);
+				_consumer.glow_width.set_float(_outer_glow_width);
+				_consumer.glow_sharpness.set_float(_outer_glow_sharpness);
+				_consumer.glow_sharpness_inv.set_float(_outer_glow_sharpness_inv);
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "GlowOuter")) {
 					streamfx::gs_draw_fullscreen_tri();
 				}
 			}
 			if (_inner_glow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pGlowColor").set_float4(_inner_glow_color);
-				_sdf_consumer_effect.get_parameter("pGlowWidth").set_float(_inner_glow_width);
-				_sdf_consumer_effect.get_parameter("pGlowSharpness").set_float(_inner_glow_sharpness);
-				_sdf_consumer_effect.get_parameter("pGlowSharpnessInverse").set_float(_inner_glow_sharpness_inv);
+				_consumer.sdf_texture.set_texture(_sdf_texture);
+				_consumer.sdf_threshold.set_float(_sdf_threshold);
+				_consumer.image_texture.set_texture(_source_texture->get_object());
+				_consumer.glow_color.set_float4(_inner_glow_color);
+				_consumer.glow_width.set_float(_inner_glow_width);
+				_consumer.glow_sharpness.set_float(_inner_glow_sharpness);
+				_consumer.glow_sharpness_inv.set_float(_inner_glow_sharpness_inv);
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "GlowInner")) {
 					streamfx::gs_draw_fullscreen_tri();
 				}
 			}
 			if (_outline) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pOutlineColor").set_float4(_outline_color);
-				_sdf_consumer_effect.get_parameter("pOutlineWidth").set_float(_outline_width);
-				_sdf_consumer_effect.get_parameter("pOutlineOffset").set_float(_outline_offset);
-				_sdf_consumer_effect.get_parameter("pOutlineSharpness").set_float(_outline_sharpness);
-				_sdf_consumer_effect.get_parameter("pOutlineSharpnessInverse").set_float(_outline_sharpness_inv);
+				_consumer.sdf_texture.set_texture(_sdf_texture);
+				_consumer.sdf_threshold.set_float(_sdf_threshold);
+				_consumer.image_texture.set_texture(_source_texture->get_object());
+				_consumer.outline_color.set_float4(_outline_color);
+				_consumer.outline_width.set_float(_outline_width);
+				_consumer.outline_offset.set_float(_outline_offset);
+				_consumer.outline_sharpness.set_float(_outline_sharpness);
+				_consumer.outline_sharpness_inv.set_float(_outline_sharpness_inv);
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "Outline")) {
 					streamfx::gs_draw_fullscreen_tri();
 				}
@@ -19,6 +19,9 @@
 
 #pragma once
 #include "common.hpp"
+#include <atomic>
+#include "gfx/gfx-change-detector.hpp"
+#include "gfx/gfx-sdf-jump-flood.hpp"
 #include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-sampler.hpp"
@@ -28,20 +31,42 @@
 
 namespace streamfx::filter::sdf_effects {
 	class sdf_effects_instance : public obs::source_instance {
-		gs::effect _sdf_producer_effect;
 		gs::effect _sdf_consumer_effect;
 
+		// Consumer parameters, resolved once after loading.
+		struct {
+			gs::effect_parameter sdf_texture;
+			gs::effect_parameter sdf_threshold;
+			gs::effect_parameter image_texture;
+			gs::effect_parameter shadow_color;
+			gs::effect_parameter shadow_min;
+			gs::effect_parameter shadow_max;
+			gs::effect_parameter shadow_offset;
+			gs::effect_parameter glow_color;
+			gs::effect_parameter glow_width;
+			gs::effect_parameter glow_sharpness;
+			gs::effect_parameter glow_sharpness_inv;
+			gs::effect_parameter outline_color;
+			gs::effect_parameter outline_width;
+			gs::effect_parameter outline_offset;
+			gs::effect_parameter outline_sharpness;
+			gs::effect_parameter outline_sharpness_inv;
+		} _consumer;
+
 		// Input
 		std::shared_ptr<gs::rendertarget> _source_rt;
 		std::shared_ptr<gs::texture>      _source_texture;
 		bool                              _source_rendered;
 
+		// Change Detection
+		std::shared_ptr<gfx::change_detector> _change_detector;
+		std::atomic_bool                      _dirty;
+
 		// Distance Field
-		std::shared_ptr<gs::rendertarget> _sdf_write;
-		std::shared_ptr<gs::rendertarget> _sdf_read;
-		std::shared_ptr<gs::texture>      _sdf_texture;
-		double_t                          _sdf_scale;
-		float_t                           _sdf_threshold;
+		std::shared_ptr<gfx::sdf_jump_flood> _sdf;
+		std::shared_ptr<gs::texture>         _sdf_texture;
+		double_t                             _sdf_scale;
+		float_t                              _sdf_threshold;
 
 		// Effects
 		bool                              _output_rendered;
@@ -19,6 +19,7 @@
 #include <cmath>
 #include <memory>
 #include <stdexcept>
+#include "gfx/gfx-effect-registry.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "plugin.hpp"
 
@@ -38,7 +39,7 @@ gfx::blur::box_linear_data::box_linear_data()
 {
 	auto gctx = gs::context();
 	try {
-		_effect = gs::effect::create(streamfx::data_file_path("effects/blur/box-linear.effect").u8string());
+		_effect = gfx::effect_registry::get()->load(streamfx::data_file_path("effects/blur/box-linear.effect"));
 	} catch (...) {
 		DLOG_ERROR("<gfx::blur::box_linear> Failed to load _effect.");
 	}
@@ -17,6 +17,7 @@
 
 #include "gfx-blur-dual-filtering.hpp"
 #include <stdexcept>
+#include "gfx/gfx-effect-registry.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "plugin.hpp"
 
@@ -54,7 +55,7 @@ gfx::blur::dual_filtering_data::dual_filtering_data()
 {
 	auto gctx = gs::context();
 	try {
-		_effect = gs::effect::create(streamfx::data_file_path("effects/blur/dual-filtering.effect").u8string());
+		_effect = gfx::effect_registry::get()->load(streamfx::data_file_path("effects/blur/dual-filtering.effect"));
 	} catch (...) {
 		DLOG_ERROR("<gfx::blur::box_linear> Failed to load _effect.");
 	}
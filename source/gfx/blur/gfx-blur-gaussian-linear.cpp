@@ -17,6 +17,7 @@
 
 #include "gfx-blur-gaussian-linear.hpp"
 #include <stdexcept>
+#include "gfx/gfx-effect-registry.hpp"
 #include "obs/gs/gs-helper.hpp"
 
 #ifdef _MSC_VER
@@ -43,7 +44,7 @@
 gfx::blur::gaussian_linear_data::gaussian_linear_data()
 {
 	auto gctx = gs::context();
-	_effect   = gs::effect::create(streamfx::data_file_path("effects/blur/gaussian-linear.effect").u8string());
+	_effect   = gfx::effect_registry::get()->load(streamfx::data_file_path("effects/blur/gaussian-linear.effect"));
 
 	// Precalculate Kernels
 	for (std::size_t kernel_size = 1; kernel_size <= MAX_BLUR_SIZE; kernel_size++) {
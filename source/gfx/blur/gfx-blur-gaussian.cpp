@@ -17,6 +17,7 @@
 
 #include "gfx-blur-gaussian.hpp"
 #include <stdexcept>
+#include "gfx/gfx-effect-registry.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "plugin.hpp"
 
@@ -44,7 +45,7 @@
 gfx::blur::gaussian_data::gaussian_data()
 {
 	auto gctx = gs::context();
-	_effect   = gs::effect::create(streamfx::data_file_path("effects/blur/gaussian.effect").u8string());
+	_effect   = gfx::effect_registry::get()->load(streamfx::data_file_path("effects/blur/gaussian.effect"));
 
 	// Precalculate Kernels
 	for (std::size_t kernel_size = 1; kernel_size <= MAX_BLUR_SIZE; kernel_size++) {
@@ -0,0 +1,180 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "gfx-change-detector.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "gfx-effect-registry.hpp"
+#include "obs/gs/gs-helper.hpp"
+#include "plugin.hpp"
+
+#define LOCAL_PREFIX "<gfx::change_detector> "
+
+// Maximum width and height of the signature. Each signature pixel covers a block of the input texture.
+#define SIGNATURE_SIZE 64
+
+// Largest block a single reduction can cover without skipping texels, see change-detection.effect.
+#define MAX_BLOCK_SIZE 32
+
+gfx::change_detector::change_detector()
+	: _effect(), _param_image(), _param_image_texel(), _param_block_size(), _levels(), _level_sizes(), _rt(),
+	  _stages(), _stage(0), _staged(false), _texture_width(0), _texture_height(0), _width(0), _height(0), _signature(),
+	  _changed(true)
+{
+	auto gctx = gs::context();
+
+	auto path = streamfx::data_file_path("effects/change-detection.effect").u8string();
+	try {
+		_effect = gfx::effect_registry::get()->load(path);
+	} catch (const std::exception& ex) {
+		DLOG_ERROR(LOCAL_PREFIX "Failed to load effect '%s': %s", path.c_str(), ex.what());
+		throw;
+	}
+
+	_param_image       = _effect.get_parameter("pImage");
+	_param_image_texel = _effect.get_parameter("pImageTexel");
+	_param_block_size  = _effect.get_parameter("pBlockSize");
+
+	_rt = std::make_shared<gs::rendertarget>(GS_RGBA32F, GS_ZS_NONE);
+}
+
+gfx::change_detector::~change_detector()
+{
+	auto gctx = gs::context();
+	for (auto& stage : _stages) {
+		if (stage) {
+			gs_stagesurface_destroy(stage);
+			stage = nullptr;
+		}
+	}
+	_levels.clear();
+	_rt.reset();
+	_effect.reset();
+}
+
+bool gfx::change_detector::update(std::shared_ptr<gs::texture> texture)
+{
+	uint32_t width  = std::min<uint32_t>(texture->get_width(), SIGNATURE_SIZE);
+	uint32_t height = std::min<uint32_t>(texture->get_height(), SIGNATURE_SIZE);
+
+	// A resized texture always counts as changed, and a different signature size invalidates everything staged.
+	if ((texture->get_width() != _texture_width) || (texture->get_height() != _texture_height)) {
+		_texture_width  = texture->get_width();
+		_texture_height = texture->get_height();
+		reset();
+
+		// Textures larger than SIGNATURE_SIZE * MAX_BLOCK_SIZE need intermediate reductions, or texels are skipped.
+		_level_sizes.clear();
+		uint32_t level_width  = _texture_width;
+		uint32_t level_height = _texture_height;
+		while ((level_width > (width * MAX_BLOCK_SIZE)) || (level_height > (height * MAX_BLOCK_SIZE))) {
+			level_width  = std::max((level_width + MAX_BLOCK_SIZE - 1) / MAX_BLOCK_SIZE, width);
+			level_height = std::max((level_height + MAX_BLOCK_SIZE - 1) / MAX_BLOCK_SIZE, height);
+			_level_sizes.emplace_back(level_width, level_height);
+		}
+		while (_levels.size() < _level_sizes.size()) {
+			_levels.push_back(std::make_shared<gs::rendertarget>(GS_RGBA32F, GS_ZS_NONE));
+		}
+		_levels.resize(_level_sizes.size());
+	}
+	if ((width != _width) || (height != _height)) {
+		for (auto& stage : _stages) {
+			if (stage) {
+				gs_stagesurface_destroy(stage);
+			}
+			stage = gs_stagesurface_create(width, height, GS_RGBA32F);
+		}
+		_width  = width;
+		_height = height;
+		_staged = false;
+		reset();
+	}
+
+	// Read back the signature staged by the previous call.
+	if (_staged) {
+		gs_stagesurf_t* stage    = _stages[_stage ^ 1];
+		uint8_t*        data     = nullptr;
+		uint32_t        linesize = 0;
+		if (gs_stagesurface_map(stage, &data, &linesize)) {
+			std::size_t row = std::size_t(_width) * 4 * sizeof(float_t);
+			if (_signature.size() != (row * _height)) {
+				_signature.resize(row * _height);
+				_changed = true;
+			}
+
+			for (uint32_t y = 0; y < _height; y++) {
+				uint8_t* src = data + std::size_t(y) * linesize;
+				uint8_t* dst = _signature.data() + std::size_t(y) * row;
+				if (memcmp(src, dst, row) != 0) {
+					memcpy(dst, src, row);
+					_changed = true;
+				}
+			}
+			gs_stagesurface_unmap(stage);
+		} else {
+			_changed = true;
+		}
+	}
+
+	// Reduce and stage the current frame.
+	{
+#ifdef ENABLE_PROFILING
+		gs::debug_marker gdm{gs::debug_color_cache, "Change Detection"};
+#endif
+		std::shared_ptr<gs::texture> level = texture;
+		for (std::size_t idx = 0; idx < _levels.size(); idx++) {
+			reduce(_levels[idx], _level_sizes[idx].first, _level_sizes[idx].second, level);
+			level = _levels[idx]->get_texture();
+		}
+		reduce(_rt, _width, _height, level);
+
+		gs_stage_texture(_stages[_stage], _rt->get_object());
+		_stage ^= 1;
+		_staged = true;
+	}
+
+	bool changed = _changed;
+	_changed     = false;
+	return changed;
+}
+
+void gfx::change_detector::reset()
+{
+	_signature.clear();
+	_changed = true;
+}
+
+void gfx::change_detector::reduce(std::shared_ptr<gs::rendertarget> target, uint32_t width, uint32_t height,
+								  std::shared_ptr<gs::texture> texture)
+{
+	vec4 transparent = {0, 0, 0, 0};
+
+	auto op = target->render(width, height);
+	gs_ortho(0, 1, 0, 1, -1, 1);
+	gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &transparent, 0, 0);
+
+	_param_image.set_texture(texture);
+	_param_image_texel.set_float2(1.0f / float_t(texture->get_width()), 1.0f / float_t(texture->get_height()));
+	_param_block_size.set_float2(float_t(texture->get_width()) / float_t(width),
+								 float_t(texture->get_height()) / float_t(height));
+	while (gs_effect_loop(_effect.get_object(), "Reduce")) {
+		streamfx::gs_draw_fullscreen_tri();
+	}
+}
@@ -0,0 +1,72 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "common.hpp"
+#include <utility>
+#include <vector>
+#include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-rendertarget.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+namespace gfx {
+	/** Detects whether the content of a texture changed between frames.
+	 *
+	 * Every call reduces the texture into a small signature on the GPU and stages it for reading. To avoid stalling
+	 * the pipeline, the signature is read back one frame later, so a change is reported one frame after it happened.
+	 */
+	class change_detector {
+		gs::effect           _effect;
+		gs::effect_parameter _param_image;
+		gs::effect_parameter _param_image_texel;
+		gs::effect_parameter _param_block_size;
+
+		std::vector<std::shared_ptr<gs::rendertarget>> _levels;
+		std::vector<std::pair<uint32_t, uint32_t>>      _level_sizes;
+		std::shared_ptr<gs::rendertarget>              _rt;
+		gs_stagesurf_t*                                _stages[2];
+		std::size_t                                    _stage;
+		bool                                           _staged;
+
+		uint32_t             _texture_width;
+		uint32_t             _texture_height;
+		uint32_t             _width;
+		uint32_t             _height;
+		std::vector<uint8_t> _signature;
+		bool                 _changed;
+
+		public:
+		change_detector();
+		~change_detector();
+
+		/** Submit the current frame and check for changes.
+		 *
+		 * @return true if the last signature that finished reading differs from the one before it, or if there is no
+		 *         previous signature to compare against.
+		 */
+		bool update(std::shared_ptr<gs::texture> texture);
+
+		/** Forget the stored signature so the next update() reports a change. */
+		void reset();
+
+		private:
+		void reduce(std::shared_ptr<gs::rendertarget> target, uint32_t width, uint32_t height,
+					std::shared_ptr<gs::texture> texture);
+	};
+} // namespace gfx
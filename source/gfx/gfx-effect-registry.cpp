@@ -0,0 +1,134 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "gfx-effect-registry.hpp"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#define LOCAL_PREFIX "<gfx::effect_registry> "
+
+// Refuse to read anything larger than this, as it is certainly not an effect file.
+#define MAX_EFFECT_SIZE 32 * 1024 * 1024
+
+static std::shared_ptr<gfx::effect_registry> effect_registry_instance;
+
+// 64-bit FNV-1a, which is fast and good enough to tell effect files apart.
+static uint64_t hash_fnv1a(const std::string& data, uint64_t hash = 14695981039346656037ull)
+{
+	for (char ch : data) {
+		hash ^= static_cast<uint8_t>(ch);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+gfx::effect_registry::effect_registry() : _lock(), _effects(), _hits(0), _misses(0) {}
+
+gfx::effect_registry::~effect_registry()
+{
+	DLOG_INFO(LOCAL_PREFIX "%" PRIu64 " hits, %" PRIu64 " misses.", _hits, _misses);
+}
+
+gs::effect gfx::effect_registry::load(const std::filesystem::path& file)
+{
+	return load(file, read(file));
+}
+
+gs::effect gfx::effect_registry::load(const std::filesystem::path& file, const std::string& code)
+{
+	std::string directory = file.parent_path().u8string();
+	uint64_t    key       = hash_fnv1a(directory, hash_fnv1a(code));
+
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		if (auto effect = find(key, directory, code); effect) {
+			_hits++;
+			return gs::effect(effect);
+		}
+	}
+
+	// Compile without holding the lock, this can take a while.
+	gs::effect effect(code, file.u8string());
+
+	std::unique_lock<std::mutex> lock(_lock);
+	if (auto existing = find(key, directory, code); existing) {
+		// Someone else compiled the same effect in the meantime.
+		_hits++;
+		return gs::effect(existing);
+	}
+
+	// Drop effects that nobody uses anymore.
+	for (auto kv = _effects.begin(); kv != _effects.end();) {
+		if (kv->second.effect.expired()) {
+			kv = _effects.erase(kv);
+		} else {
+			++kv;
+		}
+	}
+
+	_misses++;
+	_effects.emplace(key, entry{effect, directory, code});
+	return effect;
+}
+
+std::shared_ptr<gs_effect_t> gfx::effect_registry::find(uint64_t key, const std::string& directory,
+														const std::string& code)
+{
+	// Different content may share a hash, so only an exact match counts.
+	auto range = _effects.equal_range(key);
+	for (auto kv = range.first; kv != range.second; ++kv) {
+		if ((kv->second.directory == directory) && (kv->second.code == code)) {
+			if (auto effect = kv->second.effect.lock(); effect) {
+				return effect;
+			}
+		}
+	}
+	return nullptr;
+}
+
+std::string gfx::effect_registry::read(const std::filesystem::path& file)
+{
+	if (std::filesystem::file_size(file) > MAX_EFFECT_SIZE) {
+		throw std::runtime_error("File is too large to be loaded.");
+	}
+
+	std::ifstream ifs(file, std::ios::binary);
+	if (!ifs.is_open() || ifs.bad()) {
+		throw std::runtime_error("An unknown error occured trying to open the file.");
+	}
+	std::stringstream buf;
+	buf << ifs.rdbuf();
+	return buf.str();
+}
+
+void gfx::effect_registry::initialize()
+{
+	effect_registry_instance = std::make_shared<gfx::effect_registry>();
+}
+
+void gfx::effect_registry::finalize()
+{
+	effect_registry_instance.reset();
+}
+
+std::shared_ptr<gfx::effect_registry> gfx::effect_registry::get()
+{
+	return effect_registry_instance;
+}
@@ -0,0 +1,86 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "common.hpp"
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include "obs/gs/gs-effect.hpp"
+
+namespace gfx {
+	/** Deduplicates effects by their content.
+	 *
+	 * Every effect file is compiled at most once while something still uses it, regardless of how many factories
+	 * or instances load it. Entries are keyed by a hash of the file content and its directory, as the directory
+	 * decides what #include resolves to, and the content is compared on every hit so that a hash collision can't
+	 * return the wrong effect. The registry only keeps weak references, so unused effects are freed.
+	 *
+	 * libobs keeps parameter values on the effect, so users must set every parameter right before drawing, with no
+	 * other rendering in between. User shaders can't guarantee that and compile their own effect instead.
+	 */
+	class effect_registry {
+		struct entry {
+			std::weak_ptr<gs_effect_t> effect;
+			std::string                directory;
+			std::string                code;
+		};
+
+		std::mutex                     _lock;
+		std::multimap<uint64_t, entry> _effects;
+		uint64_t                       _hits;
+		uint64_t                       _misses;
+
+		public:
+		effect_registry();
+		~effect_registry();
+
+		/** Load an effect file, reusing an already compiled effect with identical content.
+		 *
+		 * @throws std::runtime_error if the file can't be read or compiled.
+		 */
+		gs::effect load(const std::filesystem::path& file);
+
+		/** Compile already read effect code, reusing an already compiled effect with identical content.
+		 *
+		 * Compiling enters the graphics context, so this blocks rendering until it is done.
+		 *
+		 * @throws std::runtime_error if the code can't be compiled.
+		 */
+		gs::effect load(const std::filesystem::path& file, const std::string& code);
+
+		private:
+		std::shared_ptr<gs_effect_t> find(uint64_t key, const std::string& directory, const std::string& code);
+
+		public:
+		/** Read the content of an effect file, for example to compile it later on the graphics thread.
+		 *
+		 * @throws std::runtime_error if the file can't be read or is too large.
+		 */
+		static std::string read(const std::filesystem::path& file);
+
+		public: // Singleton
+		static void initialize();
+
+		static void finalize();
+
+		static std::shared_ptr<gfx::effect_registry> get();
+	};
+} // namespace gfx
@@ -0,0 +1,113 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "gfx-rendertarget-pool.hpp"
+
+#define LOCAL_PREFIX "<gfx::rendertarget_pool> "
+
+// How long an unused render target is kept around before it is destroyed.
+static constexpr std::chrono::seconds unused_lifetime{5};
+
+static std::shared_ptr<gfx::rendertarget_pool> rendertarget_pool_instance;
+
+gfx::rendertarget_pool::rendertarget_pool() : _lock(), _free(), _hits(0), _misses(0) {}
+
+gfx::rendertarget_pool::~rendertarget_pool()
+{
+	DLOG_INFO(LOCAL_PREFIX "%" PRIu64 " hits, %" PRIu64 " misses.", _hits, _misses);
+}
+
+std::shared_ptr<gs::rendertarget> gfx::rendertarget_pool::acquire(gs_color_format format, uint32_t width,
+																  uint32_t height)
+{
+	key_t                             key{format, width, height};
+	std::shared_ptr<gs::rendertarget> rt;
+
+	trim();
+
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		if (auto kv = _free.find(key); (kv != _free.end()) && !kv->second.empty()) {
+			rt = kv->second.front().rt;
+			kv->second.pop_front();
+			_hits++;
+		} else {
+			_misses++;
+		}
+	}
+
+	if (!rt) {
+		rt = std::make_shared<gs::rendertarget>(format, GS_ZS_NONE);
+	}
+
+	// Hand out a reference which returns the target to the pool, instead of destroying it.
+	std::weak_ptr<rendertarget_pool> self = shared_from_this();
+	return std::shared_ptr<gs::rendertarget>(rt.get(), [self, key, rt](gs::rendertarget*) {
+		if (auto pool = self.lock(); pool) {
+			pool->release(key, rt);
+		}
+	});
+}
+
+void gfx::rendertarget_pool::trim()
+{
+	std::list<std::shared_ptr<gs::rendertarget>> expired;
+	auto                                         now = std::chrono::steady_clock::now();
+
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		for (auto kv = _free.begin(); kv != _free.end();) {
+			// Most recently released targets are at the front.
+			while (!kv->second.empty() && ((now - kv->second.back().released) > unused_lifetime)) {
+				expired.push_back(kv->second.back().rt);
+				kv->second.pop_back();
+			}
+
+			if (kv->second.empty()) {
+				kv = _free.erase(kv);
+			} else {
+				++kv;
+			}
+		}
+	}
+
+	// Destroyed outside of the lock, as this enters the graphics context.
+	expired.clear();
+}
+
+void gfx::rendertarget_pool::release(key_t key, std::shared_ptr<gs::rendertarget> rt)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	_free[key].push_front(entry{rt, std::chrono::steady_clock::now()});
+}
+
+void gfx::rendertarget_pool::initialize()
+{
+	rendertarget_pool_instance = std::make_shared<gfx::rendertarget_pool>();
+}
+
+void gfx::rendertarget_pool::finalize()
+{
+	rendertarget_pool_instance.reset();
+}
+
+std::shared_ptr<gfx::rendertarget_pool> gfx::rendertarget_pool::get()
+{
+	return rendertarget_pool_instance;
+}
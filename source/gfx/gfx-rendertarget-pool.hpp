@@ -0,0 +1,68 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "common.hpp"
+#include <chrono>
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include "obs/gs/gs-rendertarget.hpp"
+
+namespace gfx {
+	/** Pool of render targets, reused between everyone that needs a temporary target of the same format and size.
+	 *
+	 * Targets handed out by acquire() return to the pool once the last reference is gone, and are destroyed after
+	 * being unused for a while.
+	 */
+	class rendertarget_pool : public std::enable_shared_from_this<rendertarget_pool> {
+		typedef std::tuple<gs_color_format, uint32_t, uint32_t> key_t;
+
+		struct entry {
+			std::shared_ptr<gs::rendertarget>     rt;
+			std::chrono::steady_clock::time_point released;
+		};
+
+		std::mutex                        _lock;
+		std::map<key_t, std::list<entry>> _free;
+		uint64_t                          _hits;
+		uint64_t                          _misses;
+
+		public:
+		rendertarget_pool();
+		~rendertarget_pool();
+
+		/** Get a render target which is meant to be rendered at exactly the given size. */
+		std::shared_ptr<gs::rendertarget> acquire(gs_color_format format, uint32_t width, uint32_t height);
+
+		/** Destroy targets that have not been used for some time. */
+		void trim();
+
+		private:
+		void release(key_t key, std::shared_ptr<gs::rendertarget> rt);
+
+		public: // Singleton
+		static void initialize();
+
+		static void finalize();
+
+		static std::shared_ptr<gfx::rendertarget_pool> get();
+	};
+} // namespace gfx
@@ -0,0 +1,255 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "gfx-sdf-jump-flood.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "gfx-effect-registry.hpp"
+#include "obs/gs/gs-helper.hpp"
+#include "plugin.hpp"
+
+#define LOCAL_PREFIX "<gfx::sdf_jump_flood> "
+
+// Half precision floats represent every integer up to 2048 exactly, which is enough to store seed positions.
+#define HALF_PRECISION_LIMIT 2048
+
+// Largest finite half precision float, used when no wall exists at all.
+#define MAX_DISTANCE 65504.0f
+
+static std::vector<uint32_t> make_steps(uint32_t width, uint32_t height)
+{
+	uint32_t size = 1;
+	while (size < std::max(width, height)) {
+		size <<= 1;
+	}
+
+	std::vector<uint32_t> steps;
+	for (uint32_t step = size >> 1; step > 0; step >>= 1) {
+		steps.push_back(step);
+	}
+	// One additional pass with step 1 fixes most of the errors left by the regular passes (JFA+1).
+	steps.push_back(1);
+	return steps;
+}
+
+gfx::sdf_jump_flood::sdf_jump_flood()
+	: _effect(), _param_image(), _param_seeds(), _param_size(), _param_step(), _param_threshold(), _seeds_write(),
+	  _seeds_read(), _output()
+{
+	auto gctx = gs::context();
+
+	auto path = streamfx::data_file_path("effects/sdf/sdf-jump-flood.effect").u8string();
+	try {
+		_effect = gfx::effect_registry::get()->load(path);
+	} catch (const std::exception& ex) {
+		DLOG_ERROR(LOCAL_PREFIX "Failed to load effect '%s': %s", path.c_str(), ex.what());
+		throw;
+	}
+
+	_param_image     = _effect.get_parameter("pImage");
+	_param_seeds     = _effect.get_parameter("pSeeds");
+	_param_size      = _effect.get_parameter("pSize");
+	_param_step      = _effect.get_parameter("pStep");
+	_param_threshold = _effect.get_parameter("pThreshold");
+
+	_output = std::make_shared<gs::rendertarget>(GS_RG16F, GS_ZS_NONE);
+}
+
+gfx::sdf_jump_flood::~sdf_jump_flood()
+{
+	_seeds_write.reset();
+	_seeds_read.reset();
+	_output.reset();
+	_effect.reset();
+}
+
+std::shared_ptr<gs::texture> gfx::sdf_jump_flood::render(std::shared_ptr<gs::texture> image, uint32_t width,
+														 uint32_t height, float_t threshold)
+{
+	vec4 transparent = {0, 0, 0, 0};
+
+	// Seed positions need more precision than half floats offer for large fields.
+	gs_color_format seeds_format =
+		(std::max(width, height) <= HALF_PRECISION_LIMIT) ? GS_RGBA16F : GS_RGBA32F;
+	if (!_seeds_read || (_seeds_read->get_color_format() != seeds_format)) {
+		_seeds_write = std::make_shared<gs::rendertarget>(seeds_format, GS_ZS_NONE);
+		_seeds_read  = std::make_shared<gs::rendertarget>(seeds_format, GS_ZS_NONE);
+	}
+
+	std::shared_ptr<gs::texture> seeds;
+
+	{
+#ifdef ENABLE_PROFILING
+		gs::debug_marker gdm{gs::debug_color_convert, "Seed"};
+#endif
+		auto op = _seeds_write->render(width, height);
+		gs_ortho(0, 1, 0, 1, -1, 1);
+		gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &transparent, 0, 0);
+
+		_param_image.set_texture(image);
+		_param_size.set_float2(float_t(width), float_t(height));
+		_param_threshold.set_float(threshold);
+		while (gs_effect_loop(_effect.get_object(), "Seed")) {
+			streamfx::gs_draw_fullscreen_tri();
+		}
+	}
+	std::swap(_seeds_read, _seeds_write);
+
+	for (auto step : make_steps(width, height)) {
+#ifdef ENABLE_PROFILING
+		gs::debug_marker gdm{gs::debug_color_convert, "Flood %" PRIu32, step};
+#endif
+		_seeds_read->get_texture(seeds);
+
+		{
+			auto op = _seeds_write->render(width, height);
+			gs_ortho(0, 1, 0, 1, -1, 1);
+			gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &transparent, 0, 0);
+
+			_param_seeds.set_texture(seeds);
+			_param_size.set_float2(float_t(width), float_t(height));
+			_param_step.set_float(float_t(step));
+			while (gs_effect_loop(_effect.get_object(), "Flood")) {
+				streamfx::gs_draw_fullscreen_tri();
+			}
+		}
+
+		// The next step must continue from the result of this one.
+		std::swap(_seeds_read, _seeds_write);
+	}
+	_seeds_read->get_texture(seeds);
+
+	{
+#ifdef ENABLE_PROFILING
+		gs::debug_marker gdm{gs::debug_color_convert, "Resolve"};
+#endif
+		auto op = _output->render(width, height);
+		gs_ortho(0, 1, 0, 1, -1, 1);
+		gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &transparent, 0, 0);
+
+		_param_image.set_texture(image);
+		_param_seeds.set_texture(seeds);
+		_param_size.set_float2(float_t(width), float_t(height));
+		_param_threshold.set_float(threshold);
+		while (gs_effect_loop(_effect.get_object(), "Resolve")) {
+			streamfx::gs_draw_fullscreen_tri();
+		}
+	}
+
+	return _output->get_texture();
+}
+
+std::vector<float_t> gfx::sdf_jump_flood::reference(const uint8_t* alpha, uint32_t width, uint32_t height,
+													uint8_t threshold)
+{
+	struct seed {
+		int64_t x, y;
+	};
+	const seed invalid = {-1, -1};
+
+	std::size_t       count = std::size_t(width) * std::size_t(height);
+	std::vector<seed> inside(count, invalid);
+	std::vector<seed> outside(count, invalid);
+
+	// Seed
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			std::size_t idx = std::size_t(y) * width + x;
+			if (alpha[idx] > threshold) {
+				inside[idx] = {x, y};
+			} else {
+				outside[idx] = {x, y};
+			}
+		}
+	}
+
+	auto distance_sq = [](const seed& s, int64_t x, int64_t y) {
+		return (s.x - x) * (s.x - x) + (s.y - y) * (s.y - y);
+	};
+
+	// Flood
+	std::vector<seed> next_inside(count);
+	std::vector<seed> next_outside(count);
+	for (auto step : make_steps(width, height)) {
+		for (int64_t y = 0; y < height; y++) {
+			for (int64_t x = 0; x < width; x++) {
+				std::size_t idx       = std::size_t(y) * width + std::size_t(x);
+				seed        best_in   = inside[idx];
+				seed        best_out  = outside[idx];
+				int64_t     best_in_d = (best_in.x >= 0) ? distance_sq(best_in, x, y) : std::numeric_limits<int64_t>::max();
+				int64_t best_out_d = (best_out.x >= 0) ? distance_sq(best_out, x, y) : std::numeric_limits<int64_t>::max();
+
+				for (int64_t oy = -1; oy <= 1; oy++) {
+					for (int64_t ox = -1; ox <= 1; ox++) {
+						if ((ox == 0) && (oy == 0)) {
+							continue;
+						}
+
+						int64_t ax = x + ox * step;
+						int64_t ay = y + oy * step;
+						if ((ax < 0) || (ay < 0) || (ax >= width) || (ay >= height)) {
+							continue;
+						}
+
+						std::size_t aidx = std::size_t(ay) * width + std::size_t(ax);
+						if (inside[aidx].x >= 0) {
+							int64_t d = distance_sq(inside[aidx], x, y);
+							if (d < best_in_d) {
+								best_in_d = d;
+								best_in   = inside[aidx];
+							}
+						}
+						if (outside[aidx].x >= 0) {
+							int64_t d = distance_sq(outside[aidx], x, y);
+							if (d < best_out_d) {
+								best_out_d = d;
+								best_out   = outside[aidx];
+							}
+						}
+					}
+				}
+
+				next_inside[idx]  = best_in;
+				next_outside[idx] = best_out;
+			}
+		}
+		std::swap(inside, next_inside);
+		std::swap(outside, next_outside);
+	}
+
+	// Resolve
+	std::vector<float_t> result(count * 2, 0.f);
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			std::size_t idx = std::size_t(y) * width + x;
+			if (alpha[idx] > threshold) {
+				result[idx * 2 + 1] =
+					(outside[idx].x >= 0)
+						? std::min(std::sqrt(float_t(distance_sq(outside[idx], x, y))), MAX_DISTANCE)
+						: MAX_DISTANCE;
+			} else {
+				result[idx * 2] = (inside[idx].x >= 0)
+									  ? std::min(std::sqrt(float_t(distance_sq(inside[idx], x, y))), MAX_DISTANCE)
+									  : MAX_DISTANCE;
+			}
+		}
+	}
+	return result;
+}
@@ -0,0 +1,69 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "common.hpp"
+#include <vector>
+#include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-rendertarget.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+namespace gfx {
+	/** Signed Distance Field generator using the Jump Flooding Algorithm.
+	 *
+	 * Converges in ceil(log2(max(width, height))) + 1 passes within a single frame, so the result no longer depends
+	 * on how many frames the source has been visible. The output is an RG16F texture holding distances in pixels:
+	 *   R: If outside, distance to the nearest inside pixel, otherwise 0.
+	 *   G: If inside, distance to the nearest outside pixel, otherwise 0.
+	 */
+	class sdf_jump_flood {
+		gs::effect           _effect;
+		gs::effect_parameter _param_image;
+		gs::effect_parameter _param_seeds;
+		gs::effect_parameter _param_size;
+		gs::effect_parameter _param_step;
+		gs::effect_parameter _param_threshold;
+
+		std::shared_ptr<gs::rendertarget> _seeds_write;
+		std::shared_ptr<gs::rendertarget> _seeds_read;
+		std::shared_ptr<gs::rendertarget> _output;
+
+		public:
+		sdf_jump_flood();
+		~sdf_jump_flood();
+
+		/** Generate the distance field for the alpha channel of the given texture.
+		 *
+		 * @param image Source image, sampled with point filtering at the distance field resolution.
+		 * @param width Width of the distance field.
+		 * @param height Height of the distance field.
+		 * @param threshold Alpha threshold above which a pixel counts as inside.
+		 */
+		std::shared_ptr<gs::texture> render(std::shared_ptr<gs::texture> image, uint32_t width, uint32_t height,
+											float_t threshold);
+
+		public:
+		/** CPU reference implementation of the same algorithm.
+		 *
+		 * Produces width * height pairs of (outside, inside) distances with the same pass order as the GPU version,
+		 * so results can be compared without a graphics context.
+		 */
+		static std::vector<float_t> reference(const uint8_t* alpha, uint32_t width, uint32_t height, uint8_t threshold);
+	};
+} // namespace gfx
@@ -19,12 +19,16 @@
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
 
+std::map<gfx::source_texture::frame_key_t, std::weak_ptr<gfx::source_texture_frame>> gfx::source_texture::_frame_cache;
+std::mutex gfx::source_texture::_frame_cache_lock;
+
 gfx::source_texture::~source_texture()
 {
 	if (_child && _parent) {
 		obs_source_remove_active_child(_parent->get(), _child->get());
 	}
 
+	_frame.reset();
 	_parent.reset();
 	_child.reset();
 }
@@ -35,7 +39,6 @@ gfx::source_texture::source_texture(obs_source_t* parent)
 		throw std::invalid_argument("_parent must not be null");
 	}
 	_parent = std::make_shared<obs::deprecated_source>(parent, false, false);
-	_rt     = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 gfx::source_texture::source_texture(obs_source_t* _source, obs_source_t* _parent) : source_texture(_parent)
@@ -77,7 +80,6 @@ gfx::source_texture::source_texture(std::shared_ptr<obs::deprecated_source> pchi
 	}
 	this->_child  = pchild;
 	this->_parent = pparent;
-	this->_rt     = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 gfx::source_texture::source_texture(std::shared_ptr<obs::deprecated_source> _child, obs_source_t* _parent)
@@ -102,10 +104,41 @@ void gfx::source_texture::clear()
 	if (_child && _parent) {
 		obs_source_remove_active_child(_parent->get(), _child->get());
 	}
+	_frame.reset();
 	_child->clear();
 	_child.reset();
 }
 
+std::shared_ptr<gfx::source_texture_frame> gfx::source_texture::acquire_frame(obs_source_t* source, uint32_t width,
+																			  uint32_t height)
+{
+	std::unique_lock<std::mutex> lock(_frame_cache_lock);
+
+	frame_key_t key{source, width, height};
+	if (auto kv = _frame_cache.find(key); kv != _frame_cache.end()) {
+		if (auto frame = kv->second.lock(); frame) {
+			return frame;
+		}
+	}
+
+	// Drop entries that are no longer used by anyone.
+	for (auto kv = _frame_cache.begin(); kv != _frame_cache.end();) {
+		if (kv->second.expired()) {
+			kv = _frame_cache.erase(kv);
+		} else {
+			++kv;
+		}
+	}
+
+	auto frame        = std::make_shared<source_texture_frame>();
+	frame->rt         = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	frame->frame_time = 0;
+	frame->width      = width;
+	frame->height     = height;
+	_frame_cache[key] = frame;
+	return frame;
+}
+
 std::shared_ptr<gs::texture> gfx::source_texture::render(std::size_t width, std::size_t height)
 {
 	if ((width == 0) || (width >= 16384)) {
@@ -114,24 +147,37 @@ std::shared_ptr<gs::texture> gfx::source_texture::render(std::size_t width, std:
 	if ((height == 0) || (height >= 16384)) {
 		throw std::runtime_error("Height too large or too small.");
 	}
+	if (!_child) {
+		return nullptr;
+	}
 	if (_child->destroyed() || _parent->destroyed()) {
 		return nullptr;
 	}
 
-	if (_child) {
+	// Find the shared frame for this child and size.
+	if (!_frame || (_frame->width != width) || (_frame->height != height)) {
+		_frame = acquire_frame(_child->get(), static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+	}
+
+	// Only render the child if nobody else has done so for the current video frame.
+	uint64_t frame_time = obs_get_video_frame_time();
+	if (!_frame->texture || (_frame->frame_time != frame_time)) {
+		{
 #ifdef ENABLE_PROFILING
-		auto cctr =
-			gs::debug_marker(gs::debug_color_capture, "gfx::source_texture '%s'", obs_source_get_name(_child->get()));
+			auto cctr = gs::debug_marker(gs::debug_color_capture, "gfx::source_texture '%s'",
+										 obs_source_get_name(_child->get()));
 #endif
-		auto op = _rt->render(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
-		vec4 black;
-		vec4_zero(&black);
-		gs_ortho(0, static_cast<float>(width), 0, static_cast<float_t>(height), 0, 1);
-		gs_clear(GS_CLEAR_COLOR, &black, 0, 0);
-		obs_source_video_render(_child->get());
+			auto op = _frame->rt->render(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+			vec4 black;
+			vec4_zero(&black);
+			gs_ortho(0, static_cast<float>(width), 0, static_cast<float_t>(height), 0, 1);
+			gs_clear(GS_CLEAR_COLOR, &black, 0, 0);
+			obs_source_video_render(_child->get());
+		}
+
+		_frame->rt->get_texture(_frame->texture);
+		_frame->frame_time = frame_time;
 	}
 
-	std::shared_ptr<gs::texture> tex;
-	_rt->get_texture(tex);
-	return tex;
+	return _frame->texture;
 }
@@ -18,19 +18,43 @@
 #pragma once
 #include "common.hpp"
 #include <map>
+#include <mutex>
+#include <tuple>
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-texture.hpp"
 #include "obs/obs-source.hpp"
 
 namespace gfx {
+	/** Shared per-frame render of a child source at a specific size.
+	 *
+	 * All source_texture instances that render the same child at the same size share one of these, so that
+	 * the child is only rendered once per video frame no matter how many consumers there are.
+	 */
+	struct source_texture_frame {
+		std::shared_ptr<gs::rendertarget> rt;
+		std::shared_ptr<gs::texture>      texture;
+		uint64_t                          frame_time;
+		uint32_t                          width;
+		uint32_t                          height;
+	};
+
 	class source_texture {
 		std::shared_ptr<obs::deprecated_source> _parent;
 		std::shared_ptr<obs::deprecated_source> _child;
 
-		std::shared_ptr<gs::rendertarget> _rt;
+		std::shared_ptr<source_texture_frame> _frame;
 
 		source_texture(obs_source_t* parent);
 
+		private: // Frame Cache
+		typedef std::tuple<obs_source_t*, uint32_t, uint32_t> frame_key_t;
+
+		static std::map<frame_key_t, std::weak_ptr<source_texture_frame>> _frame_cache;
+		static std::mutex                                                 _frame_cache_lock;
+
+		static std::shared_ptr<source_texture_frame> acquire_frame(obs_source_t* source, uint32_t width,
+																   uint32_t height);
+
 		public:
 		~source_texture();
 		source_texture(obs_source_t* src, obs_source_t* parent);
@@ -0,0 +1,168 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "common.hpp"
+#include <list>
+#include <map>
+#include <mutex>
+#include "obs/gs/gs-texture.hpp"
+
+namespace gfx {
+	/** Shared cache of loaded textures with LRU eviction and a memory budget.
+	 *
+	 * Entries are keyed by a content key (see texture_loader::make_key) and shared via std::shared_ptr. An entry is
+	 * only ever evicted while nobody outside of the cache holds a reference to it, so the budget may be exceeded if
+	 * every cached texture is still in use. The cache does not care what it stores, so the eviction policy does not
+	 * depend on the graphics subsystem.
+	 *
+	 * Evicted values are released only after the lock is released, as destroying a texture enters the graphics
+	 * context and the render thread may be waiting on the cache at the same time.
+	 */
+	template<typename T>
+	class basic_texture_cache {
+		struct entry {
+			std::shared_ptr<T>                        value;
+			std::size_t                               size;
+			typename std::list<std::string>::iterator lru;
+		};
+
+		std::mutex                   _lock;
+		std::map<std::string, entry> _entries;
+		std::list<std::string>       _lru; // Most recently used first.
+		std::size_t                  _usage;
+		std::size_t                  _budget;
+
+		uint64_t _hits;
+		uint64_t _misses;
+		uint64_t _evictions;
+
+		public:
+		struct statistics {
+			std::size_t entries;
+			std::size_t usage;
+			std::size_t budget;
+			uint64_t    hits;
+			uint64_t    misses;
+			uint64_t    evictions;
+		};
+
+		public:
+		basic_texture_cache(std::size_t budget)
+			: _lock(), _entries(), _lru(), _usage(0), _budget(budget), _hits(0), _misses(0), _evictions(0)
+		{}
+		~basic_texture_cache() {}
+
+		/** Look up an entry, marking it as most recently used.
+		 *
+		 * @return The cached value, or nullptr if there is none.
+		 */
+		std::shared_ptr<T> find(std::string key)
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+			auto                         kv = _entries.find(key);
+			if (kv == _entries.end()) {
+				_misses++;
+				return nullptr;
+			}
+
+			_hits++;
+			_lru.splice(_lru.begin(), _lru, kv->second.lru);
+			return kv->second.value;
+		}
+
+		/** Insert or replace an entry, then evict unused entries until the budget is met again.
+		 *
+		 * @param size Memory used by the value, in bytes.
+		 */
+		void insert(std::string key, std::shared_ptr<T> value, std::size_t size)
+		{
+			std::list<std::shared_ptr<T>> expired;
+
+			{
+				std::unique_lock<std::mutex> lock(_lock);
+				if (auto kv = _entries.find(key); kv != _entries.end()) {
+					expired.push_back(std::move(kv->second.value));
+					_usage -= kv->second.size;
+					_lru.erase(kv->second.lru);
+					_entries.erase(kv);
+				}
+
+				_lru.push_front(key);
+				_entries.emplace(key, entry{std::move(value), size, _lru.begin()});
+				_usage += size;
+
+				evict(expired);
+			}
+
+			// Destroyed outside of the lock, as this enters the graphics context.
+			expired.clear();
+		}
+
+		/** Change the memory budget, evicting unused entries if necessary.
+		 */
+		void set_budget(std::size_t budget)
+		{
+			std::list<std::shared_ptr<T>> expired;
+
+			{
+				std::unique_lock<std::mutex> lock(_lock);
+				_budget = budget;
+				evict(expired);
+			}
+
+			// Destroyed outside of the lock, as this enters the graphics context.
+			expired.clear();
+		}
+
+		statistics get_statistics()
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+			return statistics{_entries.size(), _usage, _budget, _hits, _misses, _evictions};
+		}
+
+		private:
+		void drop(typename std::map<std::string, entry>::iterator kv, std::list<std::shared_ptr<T>>& expired)
+		{
+			expired.push_back(std::move(kv->second.value));
+			_usage -= kv->second.size;
+			_lru.erase(kv->second.lru);
+			_entries.erase(kv);
+			_evictions++;
+		}
+
+		void evict(std::list<std::shared_ptr<T>>& expired)
+		{
+			// Walk from least to most recently used, skipping anything that is still in use. Erasing an element of
+			// a std::list does not invalidate iterators to other elements, so 'it' stays valid.
+			auto it = _lru.end();
+			while ((_usage > _budget) && (it != _lru.begin())) {
+				auto cur = std::prev(it);
+				auto kv  = _entries.find(*cur);
+				if (kv->second.value.use_count() > 1) {
+					it = cur;
+					continue;
+				}
+				drop(kv, expired);
+			}
+		}
+	};
+
+	typedef basic_texture_cache<gs::texture> texture_cache;
+} // namespace gfx
@@ -0,0 +1,253 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "gfx-texture-loader.hpp"
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include "configuration.hpp"
+#include "obs/gs/gs-helper.hpp"
+#include "plugin.hpp"
+
+#define LOCAL_PREFIX "<gfx::texture_loader> "
+
+#define ST_CFG_CACHE_BUDGET "TextureCache.Budget"
+
+// Default texture cache budget in MiB.
+#define DEFAULT_CACHE_BUDGET 512
+
+static std::shared_ptr<gfx::texture_loader> texture_loader_instance;
+
+gfx::texture_request::texture_request(std::string path, std::string key)
+	: _lock(), _path(path), _key(key), _failed(false), _data(nullptr), _format(GS_UNKNOWN), _width(0), _height(0),
+	  _texture()
+{}
+
+gfx::texture_request::~texture_request()
+{
+	if (_data) {
+		bfree(_data);
+		_data = nullptr;
+	}
+}
+
+std::string gfx::texture_request::get_path()
+{
+	return _path;
+}
+
+bool gfx::texture_request::is_ready()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _texture != nullptr;
+}
+
+bool gfx::texture_request::has_failed()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _failed;
+}
+
+std::shared_ptr<gs::texture> gfx::texture_request::get_texture()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _texture;
+}
+
+gfx::texture_loader::texture_loader()
+	: _lock(), _requests(), _uploads(), _cache(std::size_t(DEFAULT_CACHE_BUDGET) << 20), _merged(0)
+{
+	if (auto config = streamfx::configuration::instance(); config) {
+		if (config->has(ST_CFG_CACHE_BUDGET)) {
+			_cache.set_budget(static_cast<std::size_t>(config->get_integer(ST_CFG_CACHE_BUDGET)) << 20);
+		}
+	}
+
+	obs_add_tick_callback(&tick_handler, this);
+}
+
+gfx::texture_loader::~texture_loader()
+{
+	obs_remove_tick_callback(&tick_handler, this);
+
+	auto stats = _cache.get_statistics();
+	DLOG_INFO(LOCAL_PREFIX "Texture cache had %" PRIu64 " hits, %" PRIu64 " misses and %" PRIu64 " evictions.",
+			  stats.hits, stats.misses, stats.evictions);
+	DLOG_INFO(LOCAL_PREFIX "%" PRIu64 " requests joined an already pending load.", _merged);
+
+	std::unique_lock<std::mutex> lock(_lock);
+	_uploads.clear();
+	_requests.clear();
+}
+
+std::shared_ptr<gfx::texture_request> gfx::texture_loader::load(std::string path)
+{
+	std::shared_ptr<texture_request> request;
+	std::string                      key = make_key(path);
+
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+
+		// Reuse any request for the same file that is still alive. This is neither a cache hit nor a miss.
+		if (auto kv = _requests.find(key); kv != _requests.end()) {
+			if (request = kv->second.lock(); request) {
+				_merged++;
+				return request;
+			}
+		}
+
+		// Files that are already loaded don't need to go through the thread pool at all.
+		if (auto texture = _cache.find(key); texture) {
+			request           = std::make_shared<texture_request>(path, key);
+			request->_texture = texture;
+			return request;
+		}
+
+		// Drop requests that nobody uses anymore.
+		for (auto kv = _requests.begin(); kv != _requests.end();) {
+			if (kv->second.expired()) {
+				kv = _requests.erase(kv);
+			} else {
+				++kv;
+			}
+		}
+
+		request        = std::make_shared<texture_request>(path, key);
+		_requests[key] = request;
+	}
+
+	// Decode the file on the thread pool, keeping only a weak reference to ourselves.
+	std::weak_ptr<texture_loader> self = shared_from_this();
+	streamfx::threadpool()->push(
+		[self](util::threadpool_data_t data) {
+			if (auto loader = self.lock(); loader) {
+				loader->decode(std::static_pointer_cast<texture_request>(data));
+			}
+		},
+		request);
+
+	return request;
+}
+
+void gfx::texture_loader::decode(std::shared_ptr<texture_request> request)
+{
+	gs_color_format format = GS_UNKNOWN;
+	uint32_t        width  = 0;
+	uint32_t        height = 0;
+	uint8_t*        data   = gs_create_texture_file_data(request->_path.c_str(), &format, &width, &height);
+
+	{
+		std::unique_lock<std::mutex> lock(request->_lock);
+		if (!data || (width == 0) || (height == 0)) {
+			DLOG_ERROR(LOCAL_PREFIX "Failed to decode image '%s'.", request->_path.c_str());
+			request->_failed = true;
+			if (data) {
+				bfree(data);
+			}
+			return;
+		}
+
+		request->_data   = data;
+		request->_format = format;
+		request->_width  = width;
+		request->_height = height;
+	}
+
+	std::unique_lock<std::mutex> lock(_lock);
+	_uploads.push_back(request);
+}
+
+void gfx::texture_loader::upload()
+{
+	decltype(_uploads) uploads;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		if (_uploads.size() == 0) {
+			return;
+		}
+		uploads.swap(_uploads);
+	}
+
+	for (auto request : uploads) {
+		std::unique_lock<std::mutex> lock(request->_lock);
+		try {
+			const uint8_t* mip_data[] = {request->_data};
+
+			request->_texture = std::make_shared<gs::texture>(request->_width, request->_height, request->_format, 1,
+															  mip_data, gs::texture::flags::None);
+
+			std::size_t size = std::size_t(request->_width) * std::size_t(request->_height)
+							   * std::size_t(gs_get_format_bpp(request->_format)) / 8;
+			_cache.insert(request->_key, request->_texture, size);
+		} catch (std::exception const& ex) {
+			DLOG_ERROR(LOCAL_PREFIX "Failed to upload image '%s': %s", request->_path.c_str(), ex.what());
+			request->_failed = true;
+		}
+
+		bfree(request->_data);
+		request->_data = nullptr;
+	}
+}
+
+gfx::texture_cache& gfx::texture_loader::get_cache()
+{
+	return _cache;
+}
+
+std::string gfx::texture_loader::make_key(std::string path)
+{
+	std::stringstream key;
+	key << path;
+
+	// Modified files get a new key, so that they are loaded again instead of reusing stale cache entries.
+	std::error_code ec;
+	auto            fpath = std::filesystem::u8path(path);
+	auto            mtime = std::filesystem::last_write_time(fpath, ec);
+	if (!ec) {
+		key << '|' << mtime.time_since_epoch().count();
+	}
+	auto size = std::filesystem::file_size(fpath, ec);
+	if (!ec) {
+		key << '|' << size;
+	}
+
+	return key.str();
+}
+
+void gfx::texture_loader::tick_handler(void* ptr, float_t) noexcept
+try {
+	reinterpret_cast<gfx::texture_loader*>(ptr)->upload();
+} catch (...) {
+	DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+}
+
+void gfx::texture_loader::initialize()
+{
+	texture_loader_instance = std::make_shared<gfx::texture_loader>();
+}
+
+void gfx::texture_loader::finalize()
+{
+	texture_loader_instance.reset();
+}
+
+std::shared_ptr<gfx::texture_loader> gfx::texture_loader::get()
+{
+	return texture_loader_instance;
+}
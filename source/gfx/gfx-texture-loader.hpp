@@ -0,0 +1,103 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "common.hpp"
+#include <list>
+#include <map>
+#include <mutex>
+#include "gfx-texture-cache.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+namespace gfx {
+	class texture_loader;
+
+	/** Asynchronous load of a single image file.
+	 *
+	 * The image is decoded on the plugin thread pool and uploaded to the GPU on the next graphics tick. Until then,
+	 * is_ready() returns false and consumers should keep using whatever texture they had before.
+	 */
+	class texture_request {
+		friend class texture_loader;
+
+		std::mutex  _lock;
+		std::string _path;
+		std::string _key;
+		bool        _failed;
+
+		// Decoded data, waiting for upload.
+		uint8_t*        _data;
+		gs_color_format _format;
+		uint32_t        _width;
+		uint32_t        _height;
+
+		// Uploaded texture.
+		std::shared_ptr<gs::texture> _texture;
+
+		public:
+		texture_request(std::string path, std::string key);
+		~texture_request();
+
+		std::string get_path();
+
+		bool is_ready();
+
+		bool has_failed();
+
+		std::shared_ptr<gs::texture> get_texture();
+	};
+
+	class texture_loader : public std::enable_shared_from_this<texture_loader> {
+		std::mutex                                            _lock;
+		std::map<std::string, std::weak_ptr<texture_request>> _requests;
+		std::list<std::shared_ptr<texture_request>>           _uploads;
+		gfx::texture_cache                                    _cache;
+		uint64_t                                              _merged;
+
+		public:
+		texture_loader();
+		~texture_loader();
+
+		/** Load an image file asynchronously.
+		 *
+		 * Requests for the same file content are deduplicated, so every caller asking for a file that is still in
+		 * use by someone else receives the same request (and thus the same texture). Files that were loaded before
+		 * and are still in the texture cache are returned immediately.
+		 */
+		std::shared_ptr<texture_request> load(std::string path);
+
+		gfx::texture_cache& get_cache();
+
+		/** Build the content key for a file, made from its path, modification time and size.
+		 */
+		static std::string make_key(std::string path);
+
+		private:
+		void decode(std::shared_ptr<texture_request> request);
+
+		void upload();
+
+		static void tick_handler(void* ptr, float_t time) noexcept;
+
+		public: // Singleton
+		static void                                 initialize();
+		static void                                 finalize();
+		static std::shared_ptr<gfx::texture_loader> get();
+	};
+} // namespace gfx
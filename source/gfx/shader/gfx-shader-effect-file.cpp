@@ -0,0 +1,152 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "gfx-shader-effect-file.hpp"
+#include <stdexcept>
+#include "gfx/gfx-effect-registry.hpp"
+#include "plugin.hpp"
+
+#define LOCAL_PREFIX "<gfx::shader::effect_file> "
+
+std::map<std::filesystem::path, std::weak_ptr<gfx::shader::effect_file>> gfx::shader::effect_file::_files;
+std::mutex                                                               gfx::shader::effect_file::_files_lock;
+
+gfx::shader::effect_file::effect_file(std::filesystem::path path)
+	: _lock(), _path(path), _subscription(), _code(), _pending(), _has_pending(false), _generation(0),
+	  _reading(false), _reread(false)
+{
+	// A broken file is still watched, so that it is picked up as soon as it can be read.
+	try {
+		_code = gfx::effect_registry::read(_path);
+	} catch (const std::exception& ex) {
+		DLOG_ERROR(LOCAL_PREFIX "Loading shader '%s' failed with error: %s", _path.u8string().c_str(), ex.what());
+	}
+}
+
+gfx::shader::effect_file::~effect_file()
+{
+	_subscription.reset();
+}
+
+std::filesystem::path gfx::shader::effect_file::get_path()
+{
+	return _path;
+}
+
+std::string gfx::shader::effect_file::get_code()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _code;
+}
+
+uint64_t gfx::shader::effect_file::get_generation()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _generation;
+}
+
+void gfx::shader::effect_file::update()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	if (_has_pending) {
+		_code        = std::move(_pending);
+		_has_pending = false;
+		_generation++;
+	}
+}
+
+void gfx::shader::effect_file::on_changed()
+{
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		if (_reading) {
+			// Editors often write a file in several steps, so read it again once the current read is done.
+			_reread = true;
+			return;
+		}
+		_reading = true;
+	}
+
+	std::weak_ptr<effect_file> self = shared_from_this();
+	streamfx::threadpool()->push(
+		[self](util::threadpool_data_t) {
+			if (auto file = self.lock(); file) {
+				file->read();
+			}
+		},
+		nullptr);
+}
+
+void gfx::shader::effect_file::read()
+{
+	bool again = false;
+	do {
+		try {
+			std::string code = gfx::effect_registry::read(_path);
+
+			std::unique_lock<std::mutex> lock(_lock);
+			_pending     = std::move(code);
+			_has_pending = true;
+		} catch (const std::exception& ex) {
+			DLOG_ERROR(LOCAL_PREFIX "Reading shader '%s' failed with error: %s", _path.u8string().c_str(), ex.what());
+		}
+
+		std::unique_lock<std::mutex> lock(_lock);
+		again    = _reread;
+		_reread  = false;
+		_reading = again;
+	} while (again);
+}
+
+std::shared_ptr<gfx::shader::effect_file> gfx::shader::effect_file::get(std::filesystem::path path)
+{
+	std::error_code ec;
+	if (auto canonical = std::filesystem::weakly_canonical(path, ec); !ec) {
+		path = canonical;
+	}
+
+	std::unique_lock<std::mutex> lock(_files_lock);
+	if (auto kv = _files.find(path); kv != _files.end()) {
+		if (auto file = kv->second.lock(); file) {
+			return file;
+		}
+	}
+
+	// Drop files that nobody uses anymore.
+	for (auto kv = _files.begin(); kv != _files.end();) {
+		if (kv->second.expired()) {
+			kv = _files.erase(kv);
+		} else {
+			++kv;
+		}
+	}
+
+	auto file = std::make_shared<effect_file>(path);
+	if (auto watcher = util::file_watcher::get(); watcher) {
+		std::weak_ptr<effect_file> self = file;
+		file->_subscription = watcher->watch(path, [self](const std::filesystem::path&) {
+			if (auto file = self.lock(); file) {
+				file->on_changed();
+			}
+		});
+	}
+	_files[path] = file;
+
+	return file;
+}
@@ -0,0 +1,81 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "common.hpp"
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include "util/util-file-watcher.hpp"
+
+namespace gfx {
+	namespace shader {
+		/** A shader file shared by every instance that uses it.
+		 *
+		 * The file is read once, no matter how many instances use it, and watched for changes through the shared
+		 * file watcher. Changes are read on the thread pool and only swapped in by the next call to update(), so
+		 * instances never see the code change in the middle of a frame.
+		 *
+		 * Every instance compiles its own effect from the code, as libobs keeps parameter values on the effect. A
+		 * shared effect could be overwritten by a nested render of another instance between assigning the values and
+		 * drawing. Compiling needs the graphics context, so rendering waits for it.
+		 */
+		class effect_file : public std::enable_shared_from_this<effect_file> {
+			std::mutex                         _lock;
+			std::filesystem::path              _path;
+			util::file_watcher::subscription_t _subscription;
+
+			std::string _code;
+			std::string _pending;
+			bool        _has_pending;
+			uint64_t    _generation;
+			bool        _reading;
+			bool        _reread;
+
+			public:
+			effect_file(std::filesystem::path path);
+			~effect_file();
+
+			std::filesystem::path get_path();
+
+			/** Current code, replaced whenever update() swaps in a newer one. Empty if it could not be read. */
+			std::string get_code();
+
+			/** Incremented every time new code is swapped in. */
+			uint64_t get_generation();
+
+			/** Swap in a changed file, if any. Called from the video tick. */
+			void update();
+
+			private:
+			void on_changed();
+
+			void read();
+
+			private:
+			static std::map<std::filesystem::path, std::weak_ptr<effect_file>> _files;
+			static std::mutex                                                  _files_lock;
+
+			public:
+			/** Get the shared instance for a file, loading it if nobody uses it yet. */
+			static std::shared_ptr<effect_file> get(std::filesystem::path path);
+		};
+	} // namespace shader
+} // namespace gfx
@@ -0,0 +1,328 @@
+// Modern effects for a modern Streamer
+// Copyright (C) 2019 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+
+#include "gfx-shader-param-audio.hpp"
+#include <algorithm>
+#include <cmath>
+#include "obs/obs-source-tracker.hpp"
+#include "plugin.hpp"
+
+#define LOCAL_PREFIX "<gfx::shader::audio_analyzer> "
+
+static const std::string_view _annotation_window = "window";
+
+static constexpr uint32_t window_minimum = 64;
+static constexpr uint32_t window_maximum = 8192;
+static constexpr uint32_t window_default = 1024;
+
+std::map<std::pair<obs_source_t*, uint32_t>, std::weak_ptr<gfx::shader::audio_analyzer>>
+		   gfx::shader::audio_analyzer::_analyzers;
+std::mutex gfx::shader::audio_analyzer::_analyzers_lock;
+
+gfx::shader::audio_analyzer::audio_analyzer(std::shared_ptr<obs_source_t> source, uint32_t window)
+	: _source(source), _window(window), _channels(1), _ring(), _ring_write(0), _ring_read(0), _busy(false),
+	  _fft_window(), _fft_scale(1.), _fft_cos(), _fft_sin(), _fft_reverse(), _fft_real(), _fft_imag(), _samples(),
+	  _work(), _result_lock(), _result(), _result_generation(1), _texture_generation(0), _texture()
+{
+	if (auto audio = obs_get_audio(); audio) {
+		_channels = std::max<uint32_t>(static_cast<uint32_t>(audio_output_get_channels(audio)), 1);
+	}
+
+	// Keep a few windows worth of history, so that slow analysis doesn't read samples that are being overwritten.
+	_ring.resize(static_cast<std::size_t>(_window) * 4, 0);
+
+	// Hann window, and the scale to turn its output into amplitude.
+	_fft_window.resize(_window);
+	double_t window_sum = 0.;
+	for (std::size_t idx = 0; idx < _window; idx++) {
+		double_t v       = 0.5 - 0.5 * cos((S_PI2 * static_cast<double_t>(idx)) / static_cast<double_t>(_window));
+		_fft_window[idx] = static_cast<float_t>(v);
+		window_sum += v;
+	}
+	_fft_scale = static_cast<float_t>(2. / window_sum);
+
+	// Twiddle factors for each stage are stored contiguously, so the butterflies read them linearly.
+	_fft_cos.resize(_window);
+	_fft_sin.resize(_window);
+	for (std::size_t half = 1; half < _window; half <<= 1) {
+		for (std::size_t idx = 0; idx < half; idx++) {
+			double_t angle           = -S_PI * static_cast<double_t>(idx) / static_cast<double_t>(half);
+			_fft_cos[half - 1 + idx] = static_cast<float_t>(cos(angle));
+			_fft_sin[half - 1 + idx] = static_cast<float_t>(sin(angle));
+		}
+	}
+
+	// Bit reversal permutation.
+	_fft_reverse.resize(_window);
+	uint32_t bits = static_cast<uint32_t>(util::math::get_power_of_two_exponent_floor(_window));
+	for (uint32_t idx = 0; idx < _window; idx++) {
+		uint32_t rev = 0;
+		for (uint32_t bit = 0; bit < bits; bit++) {
+			rev |= ((idx >> bit) & 1) << (bits - 1 - bit);
+		}
+		_fft_reverse[idx] = rev;
+	}
+
+	_fft_real.resize(_window);
+	_fft_imag.resize(_window);
+	_samples.resize(_window);
+	_work.resize(static_cast<std::size_t>(_window / 2) * 3);
+	_result.resize(_work.size(), 0);
+
+	obs_source_add_audio_capture_callback(_source.get(), audio_capture, this);
+}
+
+gfx::shader::audio_analyzer::~audio_analyzer()
+{
+	obs_source_remove_audio_capture_callback(_source.get(), audio_capture, this);
+}
+
+void gfx::shader::audio_analyzer::audio_capture(void* ptr, obs_source_t*, const struct audio_data* audio,
+												bool muted) noexcept
+{
+	// Runs on the audio thread, so this must never block: mix down into the ring and publish the new write position.
+	auto self = reinterpret_cast<audio_analyzer*>(ptr);
+
+	std::size_t mask  = self->_ring.size() - 1;
+	uint64_t    write = self->_ring_write.load(std::memory_order_relaxed);
+	float_t     scale = 1.0f / static_cast<float_t>(self->_channels);
+	for (uint32_t idx = 0; idx < audio->frames; idx++) {
+		float_t v = 0;
+		if (!muted) {
+			for (uint32_t ch = 0; (ch < self->_channels) && (ch < MAX_AV_PLANES); ch++) {
+				if (audio->data[ch])
+					v += reinterpret_cast<const float_t*>(audio->data[ch])[idx];
+			}
+		}
+		self->_ring[(write + idx) & mask] = v * scale;
+	}
+	self->_ring_write.store(write + audio->frames, std::memory_order_release);
+}
+
+void gfx::shader::audio_analyzer::update()
+{
+	uint64_t write = _ring_write.load(std::memory_order_acquire);
+	if (write == _ring_read)
+		return;
+
+	bool expected = false;
+	if (!_busy.compare_exchange_strong(expected, true))
+		return;
+	_ring_read = write;
+
+	std::weak_ptr<audio_analyzer> self = shared_from_this();
+	streamfx::threadpool()->push(
+		[self](util::threadpool_data_t) {
+			if (auto analyzer = self.lock(); analyzer) {
+				analyzer->analyze();
+			}
+		},
+		nullptr);
+}
+
+std::shared_ptr<gs::texture> gfx::shader::audio_analyzer::get_texture()
+{
+	std::unique_lock<std::mutex> lock(_result_lock);
+
+	uint32_t width = _window / 2;
+	if (!_texture) {
+		_texture = std::make_shared<gs::texture>(width, 3, GS_R32F, 1, nullptr, gs::texture::flags::Dynamic);
+	}
+
+	if (_texture_generation != _result_generation) {
+		gs_texture_set_image(_texture->get_object(), reinterpret_cast<const uint8_t*>(_result.data()),
+							 static_cast<uint32_t>(width * sizeof(float_t)), false);
+		_texture_generation = _result_generation;
+	}
+
+	return _texture;
+}
+
+void gfx::shader::audio_analyzer::analyze()
+try {
+	std::size_t half = _window / 2;
+
+	// Copy the latest window out of the ring.
+	{
+		std::size_t mask  = _ring.size() - 1;
+		int64_t     write = static_cast<int64_t>(_ring_write.load(std::memory_order_acquire));
+		for (std::size_t idx = 0; idx < _window; idx++) {
+			int64_t pos   = write - static_cast<int64_t>(_window) + static_cast<int64_t>(idx);
+			_samples[idx] = (pos >= 0) ? _ring[static_cast<std::size_t>(pos) & mask] : 0;
+		}
+	}
+
+	// RMS and Peak
+	float_t* levels = _work.data() + half * 2;
+	{
+		float_t sum  = 0;
+		float_t peak = 0;
+		for (std::size_t idx = 0; idx < _window; idx++) {
+			sum += _samples[idx] * _samples[idx];
+			peak = std::max(peak, std::fabs(_samples[idx]));
+		}
+		std::fill(levels, levels + half, 0.f);
+		levels[0] = std::sqrt(sum / static_cast<float_t>(_window));
+		levels[1] = peak;
+	}
+
+	// Waveform
+	float_t* waveform = _work.data() + half;
+	for (std::size_t idx = 0; idx < half; idx++) {
+		waveform[idx] = (_samples[idx * 2] + _samples[idx * 2 + 1]) * 0.5f;
+	}
+
+	// Iterative radix-2 FFT on split real/imaginary arrays, which keeps the butterfly loop vectorizable.
+	for (std::size_t idx = 0; idx < _window; idx++) {
+		_fft_real[_fft_reverse[idx]] = _samples[idx] * _fft_window[idx];
+		_fft_imag[_fft_reverse[idx]] = 0;
+	}
+	for (std::size_t size = 1; size < _window; size <<= 1) {
+		const float_t* tw_cos = _fft_cos.data() + size - 1;
+		const float_t* tw_sin = _fft_sin.data() + size - 1;
+		for (std::size_t block = 0; block < _window; block += size * 2) {
+			float_t* a_re = _fft_real.data() + block;
+			float_t* a_im = _fft_imag.data() + block;
+			float_t* b_re = a_re + size;
+			float_t* b_im = a_im + size;
+			for (std::size_t idx = 0; idx < size; idx++) {
+				float_t t_re = b_re[idx] * tw_cos[idx] - b_im[idx] * tw_sin[idx];
+				float_t t_im = b_re[idx] * tw_sin[idx] + b_im[idx] * tw_cos[idx];
+				b_re[idx]    = a_re[idx] - t_re;
+				b_im[idx]    = a_im[idx] - t_im;
+				a_re[idx] += t_re;
+				a_im[idx] += t_im;
+			}
+		}
+	}
+
+	// Spectrum
+	float_t* spectrum = _work.data();
+	for (std::size_t idx = 0; idx < half; idx++) {
+		spectrum[idx] = std::sqrt(_fft_real[idx] * _fft_real[idx] + _fft_imag[idx] * _fft_imag[idx]) * _fft_scale;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(_result_lock);
+		std::swap(_result, _work);
+		_result_generation++;
+	}
+
+	_busy = false;
+} catch (const std::exception& ex) {
+	DLOG_ERROR(LOCAL_PREFIX "Analysis failed with error: %s", ex.what());
+	_busy = false;
+} catch (...) {
+	_busy = false;
+}
+
+std::shared_ptr<gfx::shader::audio_analyzer> gfx::shader::audio_analyzer::get(std::string source, uint32_t window)
+{
+	std::shared_ptr<obs_source_t> src{obs_get_source_by_name(source.c_str()),
+									  [](obs_source_t* v) { obs_source_release(v); }};
+	if (!src.get())
+		return nullptr;
+
+	std::unique_lock<std::mutex> lock(_analyzers_lock);
+
+	// A live analyzer holds a reference to its source, so the pointer can't have been reused for another source.
+	auto key = std::make_pair(src.get(), window);
+	if (auto kv = _analyzers.find(key); kv != _analyzers.end()) {
+		if (auto analyzer = kv->second.lock(); analyzer) {
+			return analyzer;
+		}
+	}
+
+	// Drop analyzers that nobody uses anymore.
+	for (auto kv = _analyzers.begin(); kv != _analyzers.end();) {
+		if (kv->second.expired()) {
+			kv = _analyzers.erase(kv);
+		} else {
+			++kv;
+		}
+	}
+
+	auto analyzer   = std::make_shared<audio_analyzer>(src, window);
+	_analyzers[key] = analyzer;
+	return analyzer;
+}
+
+gfx::shader::audio_parameter::audio_parameter(gs::effect_parameter param, std::string prefix)
+	: parameter(param, prefix), _window(window_default), _source(), _analyzer()
+{
+	if (auto anno = get_parameter().get_annotation(_annotation_window); anno) {
+		if (anno.get_type() == gs::effect_parameter::type::Integer) {
+			int32_t v = std::clamp<int32_t>(anno.get_default_int(), window_minimum, window_maximum);
+			_window   = 1u << util::math::get_power_of_two_exponent_ceil(static_cast<uint32_t>(v));
+		}
+	}
+}
+
+gfx::shader::audio_parameter::~audio_parameter() {}
+
+void gfx::shader::audio_parameter::defaults(obs_data_t* settings)
+{
+	obs_data_set_default_string(settings, get_key().data(), "");
+}
+
+void gfx::shader::audio_parameter::properties(obs_properties_t* props, obs_data_t* settings)
+{
+	if (!is_visible())
+		return;
+
+	auto p = obs_properties_add_list(props, get_key().data(), has_name() ? get_name().data() : get_key().data(),
+									 OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
+	if (has_description())
+		obs_property_set_long_description(p, get_description().data());
+
+	obs_property_list_add_string(p, "", "");
+	obs::source_tracker::get()->enumerate(
+		[&p](std::string name, obs_source_t*) {
+			obs_property_list_add_string(p, name.c_str(), name.c_str());
+			return false;
+		},
+		obs::source_tracker::index::AudioSources);
+}
+
+void gfx::shader::audio_parameter::update(obs_data_t* settings)
+{
+	const char* source_c = obs_data_get_string(settings, get_key().data());
+	std::string source   = source_c ? source_c : "";
+	if ((source == _source) && (_analyzer || source.empty()))
+		return;
+
+	_source   = source;
+	_analyzer = source.empty() ? nullptr : audio_analyzer::get(_source, _window);
+}
+
+void gfx::shader::audio_parameter::assign()
+{
+	if (!_analyzer) {
+		get_parameter().set_texture(static_cast<gs_texture_t*>(nullptr));
+		return;
+	}
+
+	_analyzer->update();
+	get_parameter().set_texture(_analyzer->get_texture());
+}
+
+bool gfx::shader::audio_parameter::is_dynamic()
+{
+	// Without a source the texture never changes, so the shader may still be cached.
+	return static_cast<bool>(_analyzer);
+}
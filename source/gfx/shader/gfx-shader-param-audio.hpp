@@ -0,0 +1,117 @@
+// Modern effects for a modern Streamer
+// Copyright (C) 2019 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+
+#pragma once
+#include "common.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "gfx-shader-param.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+namespace gfx {
+	namespace shader {
+		/** Spectrum and waveform analysis of a source's audio, shared by every parameter using the same source and
+		 * window size.
+		 *
+		 * The audio thread only writes mixed down samples into a ring buffer, analysis happens on the thread pool and
+		 * the result is uploaded to the texture at most once per frame. The texture is R32F with window/2 columns:
+		 * - Row 0: Spectrum, linear magnitude of each frequency bin (Hann window).
+		 * - Row 1: Waveform, the analyzed window downsampled to the texture width.
+		 * - Row 2: RMS in the first column, Peak in the second.
+		 */
+		class audio_analyzer : public std::enable_shared_from_this<audio_analyzer> {
+			std::shared_ptr<obs_source_t> _source;
+			uint32_t                      _window;
+			uint32_t                      _channels;
+
+			// Audio Thread -> Analysis
+			std::vector<float_t>  _ring;
+			std::atomic<uint64_t> _ring_write;
+			uint64_t              _ring_read;
+
+			// Analysis
+			std::atomic_bool      _busy;
+			std::vector<float_t>  _fft_window;
+			float_t               _fft_scale;
+			std::vector<float_t>  _fft_cos; // Twiddle factors, one contiguous block per stage.
+			std::vector<float_t>  _fft_sin;
+			std::vector<uint32_t> _fft_reverse;
+			std::vector<float_t>  _fft_real;
+			std::vector<float_t>  _fft_imag;
+			std::vector<float_t>  _samples;
+			std::vector<float_t>  _work;
+
+			// Analysis -> Graphics
+			std::mutex                   _result_lock;
+			std::vector<float_t>         _result;
+			uint64_t                     _result_generation;
+			uint64_t                     _texture_generation;
+			std::shared_ptr<gs::texture> _texture;
+
+			static void audio_capture(void* ptr, obs_source_t* source, const struct audio_data* audio,
+									  bool muted) noexcept;
+
+			public:
+			audio_analyzer(std::shared_ptr<obs_source_t> source, uint32_t window);
+			~audio_analyzer();
+
+			/** Queue an analysis of the latest audio, unless one is still running or nothing new arrived. */
+			void update();
+
+			/** Texture with the latest result, uploaded if it changed. Must be called in a graphics context. */
+			std::shared_ptr<gs::texture> get_texture();
+
+			private:
+			void analyze();
+
+			private:
+			static std::map<std::pair<obs_source_t*, uint32_t>, std::weak_ptr<audio_analyzer>> _analyzers;
+			static std::mutex                                                                  _analyzers_lock;
+
+			public:
+			/** Get the shared analyzer for a source and window size, creating it if nobody uses it yet.
+			 *
+			 * Analyzers are keyed by the source itself, not its name, so a renamed source keeps its analyzer and a new
+			 * source with the old name gets its own.
+			 */
+			static std::shared_ptr<audio_analyzer> get(std::string source, uint32_t window);
+		};
+
+		struct audio_parameter : public parameter {
+			uint32_t                        _window;
+			std::string                     _source;
+			std::shared_ptr<audio_analyzer> _analyzer;
+
+			public:
+			audio_parameter(gs::effect_parameter param, std::string prefix);
+			virtual ~audio_parameter();
+
+			void defaults(obs_data_t* settings) override;
+
+			void properties(obs_properties_t* props, obs_data_t* settings) override;
+
+			void update(obs_data_t* settings) override;
+
+			void assign() override;
+
+			bool is_dynamic() override;
+		};
+	} // namespace shader
+} // namespace gfx
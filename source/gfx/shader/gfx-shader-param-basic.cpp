@@ -78,10 +78,13 @@ gfx::shader::basic_field_type gfx::shader::get_field_type_from_string(std::strin
 
 gfx::shader::basic_parameter::basic_parameter(gs::effect_parameter param, std::string prefix)
 	: parameter(param, prefix), _field_type(basic_field_type::Input), _suffix(), _keys(), _names(), _min(), _max(),
-	  _step(), _values()
+	  _step(), _values(), _data(nullptr), _data_local()
 {
 	char string_buffer[256];
 
+	_data_local.resize(get_size());
+	_data = _data_local.data();
+
 	_keys.resize(get_size());
 	_names.resize(get_size());
 
@@ -160,6 +163,22 @@ void gfx::shader::basic_parameter::load_parameter_data(gs::effect_parameter para
 	parameter.get_default_value(&data.i32, 1);
 }
 
+void gfx::shader::basic_parameter::bind(basic_data* storage)
+{
+	std::copy(_data, _data + get_size(), storage);
+	_data = storage;
+	_data_local.clear();
+	_data_local.shrink_to_fit();
+}
+
+void gfx::shader::basic_parameter::assign()
+{
+	if (is_automatic())
+		return;
+
+	get_parameter().set_value(_data, get_size());
+}
+
 gfx::shader::bool_parameter::bool_parameter(gs::effect_parameter param, std::string prefix)
 	: basic_parameter(param, prefix)
 {
@@ -168,7 +187,9 @@ gfx::shader::bool_parameter::bool_parameter(gs::effect_parameter param, std::str
 	_step.resize(0);
 	_scale.resize(0);
 
-	_data.resize(get_size(), 1);
+	for (std::size_t idx = 0; idx < get_size(); idx++) {
+		_data[idx].i32 = 1;
+	}
 }
 
 gfx::shader::bool_parameter::~bool_parameter() {}
@@ -204,20 +225,13 @@ void gfx::shader::bool_parameter::update(obs_data_t* settings)
 
 	// TODO: Support for bool[]
 	if (get_size() == 1) {
-		_data[0] = static_cast<int32_t>(obs_data_get_int(settings, get_key().data()));
+		_data[0].i32 = static_cast<int32_t>(obs_data_get_int(settings, get_key().data()));
 	}
 }
 
-void gfx::shader::bool_parameter::assign()
-{
-	get_parameter().set_value(_data.data(), _data.size());
-}
-
 gfx::shader::float_parameter::float_parameter(gs::effect_parameter param, std::string prefix)
 	: basic_parameter(param, prefix)
 {
-	_data.resize(get_size());
-
 	// Reset minimum, maximum, step and scale.
 	for (std::size_t idx = 0; idx < get_size(); idx++) {
 		_min[idx].f32   = std::numeric_limits<float_t>::lowest();
@@ -312,13 +326,6 @@ void gfx::shader::float_parameter::update(obs_data_t* settings)
 	}
 }
 
-void gfx::shader::float_parameter::assign()
-{
-	if (is_automatic())
-		return;
-
-	get_parameter().set_value(_data.data(), get_size());
-}
 static inline obs_property_t* build_int_property(gfx::shader::basic_field_type ft, obs_properties_t* props,
 												 const char* key, const char* name, int32_t min, int32_t max,
 												 int32_t step, std::list<gfx::shader::basic_enum_data> edata)
@@ -342,8 +349,6 @@ static inline obs_property_t* build_int_property(gfx::shader::basic_field_type f
 gfx::shader::int_parameter::int_parameter(gs::effect_parameter param, std::string prefix)
 	: basic_parameter(param, prefix)
 {
-	_data.resize(get_size());
-
 	// Reset minimum, maximum, step and scale.
 	for (std::size_t idx = 0; idx < get_size(); idx++) {
 		_min[idx].i32   = std::numeric_limits<int32_t>::lowest();
@@ -416,11 +421,3 @@ void gfx::shader::int_parameter::update(obs_data_t* settings)
 		_data[idx].i32 = static_cast<int32_t>(obs_data_get_int(settings, key_at(idx).data()) * _scale[idx].i32);
 	}
 }
-
-void gfx::shader::int_parameter::assign()
-{
-	if (is_automatic())
-		return;
-
-	get_parameter().set_value(_data.data(), get_size());
-}
@@ -46,12 +46,13 @@ namespace gfx {
 
 		class basic_parameter : public parameter {
 			// Descriptor
-			basic_field_type         _field_type;
-			std::string              _suffix;
+			basic_field_type _field_type;
+			std::string      _suffix;
+
+			protected:
 			std::vector<std::string> _keys;
 			std::vector<std::string> _names;
 
-			protected:
 			// Limits
 			std::vector<basic_data> _min;
 			std::vector<basic_data> _max;
@@ -61,12 +62,24 @@ namespace gfx {
 			// Enumeration Information
 			std::list<basic_enum_data> _values;
 
+			// Values, either in local storage or in the packed block of the shader (see bind()).
+			basic_data*             _data;
+			std::vector<basic_data> _data_local;
+
 			public:
 			basic_parameter(gs::effect_parameter param, std::string prefix);
 			virtual ~basic_parameter();
 
 			virtual void load_parameter_data(gs::effect_parameter parameter, basic_data& data);
 
+			/** Move the values into storage shared with the other basic parameters of a shader.
+			 *
+			 * The storage must hold at least get_size() elements and outlive this parameter.
+			 */
+			void bind(basic_data* storage);
+
+			void assign() override;
+
 			public:
 			inline basic_field_type field_type()
 			{
@@ -94,9 +107,6 @@ namespace gfx {
 		};
 
 		struct bool_parameter : public basic_parameter {
-			// std::vector<bool> doesn't allow .data()
-			std::vector<int32_t> _data;
-
 			public:
 			bool_parameter(gs::effect_parameter param, std::string prefix);
 			virtual ~bool_parameter();
@@ -106,13 +116,9 @@ namespace gfx {
 			void properties(obs_properties_t* props, obs_data_t* settings) override;
 
 			void update(obs_data_t* settings) override;
-
-			void assign() override;
 		};
 
 		struct float_parameter : public basic_parameter {
-			std::vector<basic_data> _data;
-
 			public:
 			float_parameter(gs::effect_parameter param, std::string prefix);
 			virtual ~float_parameter();
@@ -122,13 +128,9 @@ namespace gfx {
 			void properties(obs_properties_t* props, obs_data_t* settings) override;
 
 			void update(obs_data_t* settings) override;
-
-			void assign() override;
 		};
 
 		struct int_parameter : public basic_parameter {
-			std::vector<basic_data> _data;
-
 			public:
 			int_parameter(gs::effect_parameter param, std::string prefix);
 			virtual ~int_parameter();
@@ -138,8 +140,6 @@ namespace gfx {
 			void properties(obs_properties_t* props, obs_data_t* settings) override;
 
 			void update(obs_data_t* settings) override;
-
-			void assign() override;
 		};
 
 	} // namespace shader
@@ -0,0 +1,55 @@
+// Modern effects for a modern Streamer
+// Copyright (C) 2019 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+
+#include "gfx-shader-param-matrix.hpp"
+#include <sstream>
+
+static constexpr std::size_t matrix_rows    = 4;
+static constexpr std::size_t matrix_columns = 4;
+
+gfx::shader::matrix_parameter::matrix_parameter(gs::effect_parameter param, std::string prefix)
+	: float_parameter(param, prefix)
+{
+	if (get_size() != (matrix_rows * matrix_columns))
+		throw std::invalid_argument("Matrix parameters must be float4x4.");
+
+	// Name the fields by row and column, keys stay index based so that existing settings still apply.
+	for (std::size_t row = 0; row < matrix_rows; row++) {
+		for (std::size_t column = 0; column < matrix_columns; column++) {
+			std::stringstream sstr;
+			sstr << "[" << row << "][" << column << "]";
+			_names[row * matrix_columns + column] = sstr.str();
+		}
+	}
+}
+
+gfx::shader::matrix_parameter::~matrix_parameter() {}
+
+void gfx::shader::matrix_parameter::defaults(obs_data_t* settings)
+{
+	std::vector<float_t> defaults(get_size(), 0.f);
+	if (!get_parameter().get_default_value(defaults.data(), get_size())) {
+		for (std::size_t idx = 0; idx < matrix_rows; idx++) {
+			defaults[idx * matrix_columns + idx] = 1.f;
+		}
+	}
+
+	for (std::size_t idx = 0; idx < get_size(); idx++) {
+		obs_data_set_default_double(settings, key_at(idx).data(), static_cast<double_t>(defaults[idx]));
+	}
+}
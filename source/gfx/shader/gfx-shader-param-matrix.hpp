@@ -0,0 +1,37 @@
+// Modern effects for a modern Streamer
+// Copyright (C) 2019 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+
+#pragma once
+#include "common.hpp"
+#include "gfx-shader-param-basic.hpp"
+
+namespace gfx {
+	namespace shader {
+		/** float4x4 parameter, edited as 16 fields named by row and column.
+		 *
+		 * Matrices without a default value start out as the identity matrix instead of all zeros.
+		 */
+		struct matrix_parameter : public float_parameter {
+			public:
+			matrix_parameter(gs::effect_parameter param, std::string prefix);
+			virtual ~matrix_parameter();
+
+			void defaults(obs_data_t* settings) override;
+		};
+	} // namespace shader
+} // namespace gfx
@@ -0,0 +1,176 @@
+// Modern effects for a modern Streamer
+// Copyright (C) 2019 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+
+#include "gfx-shader-param-texture.hpp"
+#include <sstream>
+#include "obs/obs-source-tracker.hpp"
+#include "strings.hpp"
+
+#define LOCAL_PREFIX "<gfx::shader::texture_parameter> "
+
+#define ST "Shader.Parameters.Texture"
+#define ST_TYPE ST ".Type"
+#define ST_FILE ST ".File"
+#define ST_SOURCE ST ".Source"
+
+#define KEY_TYPE ".Type"
+#define KEY_FILE ".File"
+#define KEY_SOURCE ".Source"
+
+gfx::shader::texture_parameter::texture_parameter(gs::effect_parameter param, std::string prefix, obs_source_t* owner)
+	: parameter(param, prefix), _owner(owner), _key_type(), _key_file(), _key_source(),
+	  _type(texture_input_type::File), _file(), _file_loaded(), _file_request(), _source(), _source_loaded(),
+	  _source_texture(), _texture()
+{
+	_key_type   = std::string(get_key()) + KEY_TYPE;
+	_key_file   = std::string(get_key()) + KEY_FILE;
+	_key_source = std::string(get_key()) + KEY_SOURCE;
+}
+
+gfx::shader::texture_parameter::~texture_parameter() {}
+
+void gfx::shader::texture_parameter::defaults(obs_data_t* settings)
+{
+	obs_data_set_default_int(settings, _key_type.c_str(), static_cast<long long>(texture_input_type::File));
+	obs_data_set_default_string(settings, _key_file.c_str(), "");
+	obs_data_set_default_string(settings, _key_source.c_str(), "");
+}
+
+void gfx::shader::texture_parameter::properties(obs_properties_t* props, obs_data_t* settings)
+{
+	if (!is_visible())
+		return;
+
+	auto pr = obs_properties_create();
+	{
+		auto p = obs_properties_add_group(props, get_key().data(), has_name() ? get_name().data() : get_key().data(),
+										  OBS_GROUP_NORMAL, pr);
+		if (has_description())
+			obs_property_set_long_description(p, get_description().data());
+	}
+
+	{
+		auto p = obs_properties_add_list(pr, _key_type.c_str(), D_TRANSLATE(ST_TYPE), OBS_COMBO_TYPE_LIST,
+										 OBS_COMBO_FORMAT_INT);
+		obs_property_list_add_int(p, D_TRANSLATE(S_FILETYPE_IMAGE), static_cast<long long>(texture_input_type::File));
+		obs_property_list_add_int(p, D_TRANSLATE(S_SOURCETYPE_SOURCE),
+								  static_cast<long long>(texture_input_type::Source));
+	}
+
+	{
+		std::stringstream filter;
+		filter << D_TRANSLATE(S_FILETYPE_IMAGES) << " (" << S_FILEFILTERS_TEXTURE << ");;* (*.*)";
+		obs_properties_add_path(pr, _key_file.c_str(), D_TRANSLATE(ST_FILE), OBS_PATH_FILE, filter.str().c_str(),
+								nullptr);
+	}
+
+	{
+		auto p = obs_properties_add_list(pr, _key_source.c_str(), D_TRANSLATE(ST_SOURCE), OBS_COMBO_TYPE_LIST,
+										 OBS_COMBO_FORMAT_STRING);
+		obs_property_list_add_string(p, "", "");
+		obs::source_tracker::get()->enumerate(
+			[&p](std::string name, obs_source_t*) {
+				std::stringstream sstr;
+				sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SOURCE) << ")";
+				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
+				return false;
+			},
+			obs::source_tracker::index::VideoSources);
+		obs::source_tracker::get()->enumerate(
+			[&p](std::string name, obs_source_t*) {
+				std::stringstream sstr;
+				sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SCENE) << ")";
+				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
+				return false;
+			},
+			obs::source_tracker::index::Scenes);
+	}
+}
+
+void gfx::shader::texture_parameter::update(obs_data_t* settings)
+{
+	// Only remember what was selected, the actual work happens in assign() on the graphics thread.
+	_type   = static_cast<texture_input_type>(obs_data_get_int(settings, _key_type.c_str()));
+	_file   = obs_data_get_string(settings, _key_file.c_str());
+	_source = obs_data_get_string(settings, _key_source.c_str());
+}
+
+void gfx::shader::texture_parameter::assign()
+{
+	switch (_type) {
+	case texture_input_type::File:
+		_source_texture.reset();
+		_source_loaded.clear();
+
+		if (_file_loaded != _file) {
+			// Keep the current texture until the new one has been loaded.
+			_file_loaded  = _file;
+			_file_request = _file.empty() ? nullptr : gfx::texture_loader::get()->load(_file);
+			if (_file.empty())
+				_texture.reset();
+		}
+		if (_file_request) {
+			if (_file_request->is_ready()) {
+				_texture = _file_request->get_texture();
+				_file_request.reset();
+			} else if (_file_request->has_failed()) {
+				DLOG_ERROR(LOCAL_PREFIX "Failed to load image '%s'.", _file.c_str());
+				_texture.reset();
+				_file_request.reset();
+			}
+		}
+		break;
+	case texture_input_type::Source:
+		_file_request.reset();
+		_file_loaded.clear();
+
+		if (_source_loaded != _source) {
+			_source_loaded = _source;
+			_source_texture.reset();
+			if (!_source.empty()) {
+				try {
+					_source_texture = std::make_shared<gfx::source_texture>(_source, _owner);
+				} catch (const std::exception& ex) {
+					DLOG_ERROR(LOCAL_PREFIX "Failed to use source '%s': %s", _source.c_str(), ex.what());
+				}
+			}
+		}
+
+		_texture.reset();
+		if (_source_texture) {
+			uint32_t width  = obs_source_get_width(_source_texture->get_object());
+			uint32_t height = obs_source_get_height(_source_texture->get_object());
+			if ((width > 0) && (height > 0)) {
+				_texture = _source_texture->render(width, height);
+			}
+		}
+		break;
+	}
+
+	if (_texture) {
+		get_parameter().set_texture(_texture);
+	} else {
+		get_parameter().set_texture(static_cast<gs_texture_t*>(nullptr));
+	}
+}
+
+bool gfx::shader::texture_parameter::is_dynamic()
+{
+	// Sources change every frame, files only until they have finished loading.
+	return (_type == texture_input_type::Source) || (_file_loaded != _file) || _file_request;
+}
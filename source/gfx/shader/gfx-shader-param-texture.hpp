@@ -0,0 +1,75 @@
+// Modern effects for a modern Streamer
+// Copyright (C) 2019 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+
+#pragma once
+#include "common.hpp"
+#include "gfx-shader-param.hpp"
+#include "gfx/gfx-source-texture.hpp"
+#include "gfx/gfx-texture-loader.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+namespace gfx {
+	namespace shader {
+		enum class texture_input_type {
+			File,
+			Source,
+		};
+
+		/** Additional texture input, taken either from an image file or from another source.
+		 *
+		 * Files go through the shared texture loader, so they are decoded off the graphics thread and every shader
+		 * using the same file shares one texture. Sources go through gfx::source_texture, which renders each source
+		 * and size only once per frame no matter how many shaders use it.
+		 */
+		struct texture_parameter : public parameter {
+			obs_source_t* _owner;
+
+			std::string _key_type;
+			std::string _key_file;
+			std::string _key_source;
+
+			texture_input_type _type;
+
+			// File
+			std::string                           _file;
+			std::string                           _file_loaded;
+			std::shared_ptr<gfx::texture_request> _file_request;
+
+			// Source
+			std::string                          _source;
+			std::string                          _source_loaded;
+			std::shared_ptr<gfx::source_texture> _source_texture;
+
+			std::shared_ptr<gs::texture> _texture;
+
+			public:
+			texture_parameter(gs::effect_parameter param, std::string prefix, obs_source_t* owner);
+			virtual ~texture_parameter();
+
+			void defaults(obs_data_t* settings) override;
+
+			void properties(obs_properties_t* props, obs_data_t* settings) override;
+
+			void update(obs_data_t* settings) override;
+
+			void assign() override;
+
+			bool is_dynamic() override;
+		};
+	} // namespace shader
+} // namespace gfx
@@ -18,7 +18,11 @@
 #include "gfx-shader-param.hpp"
 #include <algorithm>
 #include <sstream>
+#include <stdexcept>
+#include "gfx-shader-param-audio.hpp"
 #include "gfx-shader-param-basic.hpp"
+#include "gfx-shader-param-matrix.hpp"
+#include "gfx-shader-param-texture.hpp"
 
 #define ANNO_ORDER "order"
 #define ANNO_VISIBILITY "visible"
@@ -28,6 +32,8 @@
 #define ANNO_TYPE "type"
 #define ANNO_SIZE "size"
 
+#define LOCAL_PREFIX "<gfx::shader::parameter> "
+
 typedef gs::effect_parameter::type eptype;
 
 gfx::shader::parameter_type gfx::shader::get_type_from_effect_type(gs::effect_parameter::type type)
@@ -102,6 +108,12 @@ gfx::shader::parameter_type gfx::shader::get_type_from_string(std::string v)
 	if ((v == "sampler")) {
 		return parameter_type::Sampler;
 	}
+	if ((v == "audio")) {
+		return parameter_type::Audio;
+	}
+	if ((v == "buffer")) {
+		return parameter_type::Buffer;
+	}
 	/* To decide on in the future:
 	 * - Double support?
 	 * - Half Support?
@@ -175,8 +187,14 @@ void gfx::shader::parameter::update(obs_data_t* settings) {}
 
 void gfx::shader::parameter::assign() {}
 
+bool gfx::shader::parameter::is_dynamic()
+{
+	return false;
+}
+
 std::shared_ptr<gfx::shader::parameter> gfx::shader::parameter::make_parameter(gs::effect_parameter param,
-																			   std::string          prefix)
+																			   std::string          prefix,
+																			   obs_source_t*        owner)
 {
 	if (!param) {
 		throw std::runtime_error("Bad call to make_parameter. This is a bug in the plugin.");
@@ -185,7 +203,7 @@ std::shared_ptr<gfx::shader::parameter> gfx::shader::parameter::make_parameter(g
 	parameter_type real_type = get_type_from_effect_type(param.get_type());
 	if (auto anno = param.get_annotation(ANNO_TYPE); anno) {
 		// We have a type override.
-		real_type = get_type_from_string(param.get_default_string());
+		real_type = get_type_from_string(anno.get_default_string());
 	}
 
 	switch (real_type) {
@@ -194,7 +212,20 @@ std::shared_ptr<gfx::shader::parameter> gfx::shader::parameter::make_parameter(g
 	case parameter_type::Integer:
 		return std::make_shared<gfx::shader::int_parameter>(param, prefix);
 	case parameter_type::Float:
+		if (param.get_type() == eptype::Matrix) {
+			try {
+				return std::make_shared<gfx::shader::matrix_parameter>(param, prefix);
+			} catch (const std::invalid_argument& ex) {
+				// Don't fail the entire shader over one badly annotated parameter.
+				DLOG_WARNING(LOCAL_PREFIX "Treating matrix '%s' as a list of floats: %s", param.get_name().data(),
+							 ex.what());
+			}
+		}
 		return std::make_shared<gfx::shader::float_parameter>(param, prefix);
+	case parameter_type::Texture:
+		return std::make_shared<gfx::shader::texture_parameter>(param, prefix, owner);
+	case parameter_type::Audio:
+		return std::make_shared<gfx::shader::audio_parameter>(param, prefix);
 	default:
 		return nullptr;
 	}
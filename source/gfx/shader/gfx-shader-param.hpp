@@ -36,7 +36,11 @@ namespace gfx {
 			// Texture with dimensions stored in size (1 = Texture1D, 2 = Texture2D, 3 = Texture3D, 6 = TextureCube).
 			Texture,
 			// Sampler for Textures.
-			Sampler
+			Sampler,
+			// Audio analysis of a source, provided as a Texture.
+			Audio,
+			// Intermediate buffer rendered by the shader itself, provided as a Texture.
+			Buffer
 		};
 
 		parameter_type get_type_from_effect_type(gs::effect_parameter::type type);
@@ -80,6 +84,9 @@ namespace gfx {
 
 			virtual void assign();
 
+			// Does the value change on its own (without settings changing), so the output can't be cached?
+			virtual bool is_dynamic();
+
 			public:
 			inline gs::effect_parameter get_parameter()
 			{
@@ -137,7 +144,8 @@ namespace gfx {
 			}
 
 			public:
-			static std::shared_ptr<parameter> make_parameter(gs::effect_parameter param, std::string prefix);
+			static std::shared_ptr<parameter> make_parameter(gs::effect_parameter param, std::string prefix,
+															 obs_source_t* owner);
 		};
 	} // namespace shader
 } // namespace gfx
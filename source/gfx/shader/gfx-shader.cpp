@@ -17,8 +17,11 @@
 
 #include "gfx-shader.hpp"
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
+#include "gfx/gfx-rendertarget-pool.hpp"
+#include "obs/gs/gs-helper.hpp"
 #include "obs/obs-tools.hpp"
 #include "plugin.hpp"
 
@@ -33,16 +36,21 @@
 #define ST_SHADER_SEED ST_SHADER ".Seed"
 #define ST_PARAMETERS ST ".Parameters"
 
+#define HISTORY_PARAMETER "PreviousFrame"
+#define HISTORY_DEPTH_MAXIMUM 8
+
 gfx::shader::shader::shader(obs_source_t* self, shader_mode mode)
 	: _self(self), _mode(mode), _base_width(1), _base_height(1), _active(true),
 
-	  _shader(), _shader_file(), _shader_tech("Draw"), _shader_file_mt(), _shader_file_sz(), _shader_file_tick(0),
+	  _shader(), _shader_file(), _shader_effect_file(), _shader_generation(0), _shader_tech("Draw"),
+	  _shader_static(false),
 
 	  _width_type(size_type::Percent), _width_value(1.0), _height_type(size_type::Percent), _height_value(1.0),
 
 	  _have_current_params(false), _time(0), _time_loop(0), _loops(0), _random(), _random_seed(0),
 
-	  _rt_up_to_date(false), _rt(std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE))
+	  _rt_up_to_date(false), _rt(std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE)), _rt_renders(0),
+	  _rt_cache(false)
 {
 	// Intialize random values.
 	_random.seed(static_cast<unsigned long long>(_random_seed));
@@ -55,26 +63,15 @@ gfx::shader::shader::shader(obs_source_t* self, shader_mode mode)
 gfx::shader::shader::~shader() {}
 
 bool gfx::shader::shader::is_shader_different(const std::filesystem::path& file)
-try {
-	if (std::filesystem::exists(file)) {
-		// Check if the file name differs.
-		if (file != _shader_file)
-			return true;
-	}
-
-	if (std::filesystem::exists(_shader_file)) {
-		// Is the file write time different?
-		if (std::filesystem::last_write_time(_shader_file) != _shader_file_mt)
-			return true;
+{
+	// Is the file name different?
+	if (!_shader_effect_file || (file != _shader_file))
+		return true;
 
-		// Is the file size different?
-		if (std::filesystem::file_size(_shader_file) != _shader_file_sz)
-			return true;
-	}
+	// Was the file changed and recompiled?
+	if (_shader_effect_file->get_generation() != _shader_generation)
+		return true;
 
-	return false;
-} catch (const std::exception& ex) {
-	DLOG_ERROR("Loading shader '%s' failed with error: %s", file.c_str(), ex.what());
 	return false;
 }
 
@@ -87,10 +84,34 @@ bool gfx::shader::shader::is_technique_different(const std::string& tech)
 	return false;
 }
 
+static gs::effect_parameter find_texture_parameter(gs::effect& effect, std::initializer_list<const char*> names)
+{
+	for (auto name : names) {
+		if (auto el = effect.get_parameter(name, gs::effect_parameter::type::Texture); el)
+			return el;
+	}
+	return nullptr;
+}
+
+bool gfx::shader::shader::is_input_parameter(gs::effect_parameter& param)
+{
+	// Inputs are provided by the filter, transition or shader itself, and must not show up as user parameters.
+	if ((_param_input_a && (param.get_name() == _param_input_a.get_name()))
+		|| (_param_input_b && (param.get_name() == _param_input_b.get_name())))
+		return true;
+
+	for (auto& history : _history_params) {
+		if (param.get_name() == history.get_name())
+			return true;
+	}
+
+	return false;
+}
+
 bool gfx::shader::shader::load_shader(const std::filesystem::path& file, const std::string& tech, bool& shader_dirty,
 									  bool& param_dirty)
 try {
-	if (!std::filesystem::exists(file))
+	if (file.empty())
 		return false;
 
 	shader_dirty = is_shader_different(file);
@@ -98,11 +119,90 @@ try {
 
 	// Update Shader
 	if (shader_dirty) {
-		_shader           = gs::effect(file);
-		_shader_file_mt   = std::filesystem::last_write_time(file);
-		_shader_file_sz   = std::filesystem::file_size(file);
-		_shader_file      = file;
-		_shader_file_tick = 0;
+		// The file is read by the shared effect file, which also tracks changes, so there is no need to touch the
+		// disk here. A file that could not be read has no code.
+		auto        effect_file = gfx::shader::effect_file::get(file);
+		std::string code        = effect_file->get_code();
+		if (code.empty())
+			return false;
+
+		bool reload         = _shader_effect_file && (file == _shader_file);
+		_shader_effect_file = effect_file;
+		_shader_generation  = _shader_effect_file->get_generation();
+		_shader_file        = file;
+
+		// Compile our own effect, as libobs keeps parameter values on it. Sharing it with other instances of the same
+		// file would let their nested renders overwrite our values between assigning them and drawing.
+		{
+			auto gctx = gs::context();
+			if (!reload) {
+				_shader.reset();
+			}
+			// A broken reload keeps the previous effect, the file is likely still being edited.
+			_shader = gs::effect(code, file.u8string());
+		}
+		if (!_shader)
+			throw std::runtime_error("Shader failed to compile.");
+
+		// Resolve built-in parameters now, instead of looking them up by name every frame.
+		using type = gs::effect_parameter::type;
+
+		_param_time            = _shader.get_parameter("Time", type::Float4);
+		_param_view_size       = _shader.get_parameter("ViewSize", type::Float4);
+		_param_random          = _shader.get_parameter("Random", type::Matrix);
+		_param_random_seed     = _shader.get_parameter("RandomSeed", type::Integer);
+		_param_transition_time = _shader.get_parameter("TransitionTime", type::Float);
+		_param_transition_size = _shader.get_parameter("TransitionSize", type::Integer2);
+		_param_input_a         = find_texture_parameter(_shader, {"InputA", "image", "tex_a"});
+		_param_input_b         = find_texture_parameter(_shader, {"InputB", "image2", "tex_b"});
+
+		// History of previous outputs, the depth is decided by how many PreviousFrame parameters are declared.
+		_history_params.clear();
+		_history.clear();
+		if (auto el = _shader.get_parameter(HISTORY_PARAMETER, type::Texture); el) {
+			_history_params.push_back(el);
+			for (std::size_t idx = 2; idx <= HISTORY_DEPTH_MAXIMUM; idx++) {
+				auto older = _shader.get_parameter(HISTORY_PARAMETER + std::to_string(idx), type::Texture);
+				if (!older)
+					break;
+				_history_params.push_back(older);
+			}
+		}
+
+		// Intermediate buffers, rendered in the order they are declared.
+		_shader_buffers.clear();
+		for (std::size_t idx = 0; idx < _shader.count_parameters(); idx++) {
+			auto el = _shader.get_parameter(idx);
+			if (!el || (el.get_type() != type::Texture))
+				continue;
+			if (auto anno = el.get_annotation("type"); !anno || (anno.get_default_string() != "buffer"))
+				continue;
+
+			shader_buffer buffer;
+			buffer.param  = el;
+			buffer.scale  = 1.0;
+			buffer.format = GS_RGBA;
+			if (auto anno = el.get_annotation("technique"); anno && (anno.get_type() == type::String)) {
+				buffer.technique = anno.get_default_string();
+			}
+			if (auto anno = el.get_annotation("scale"); anno && (anno.get_type() == type::Float)) {
+				buffer.scale = std::clamp(static_cast<double_t>(anno.get_default_float()), 0.01, 1.0);
+			}
+			if (auto anno = el.get_annotation("format"); anno && (anno.get_type() == type::String)) {
+				if (auto format = anno.get_default_string(); format == "rgba16f") {
+					buffer.format = GS_RGBA16F;
+				} else if (format == "rgba32f") {
+					buffer.format = GS_RGBA32F;
+				}
+			}
+
+			if (!_shader.has_technique(buffer.technique)) {
+				DLOG_ERROR("Buffer '%s' refers to unknown technique '%s', ignoring it.", el.get_name().data(),
+						   buffer.technique.c_str());
+				continue;
+			}
+			_shader_buffers.push_back(buffer);
+		}
 	}
 
 	// Update Params
@@ -126,52 +226,76 @@ try {
 			obs_data_set_string(settings.get(), ST_SHADER_TECHNIQUE, _shader_tech.c_str());
 		}
 
-		// Clear the shader parameters map and rebuild.
+		// Clear the shader parameters map and rebuild it from the main technique and all buffer techniques.
 		_shader_params.clear();
-		auto etech = _shader.get_technique(_shader_tech);
-		for (std::size_t idx = 0; idx < etech.count_passes(); idx++) {
-			auto pass = etech.get_pass(idx);
+		std::list<std::string> techniques = {_shader_tech};
+		for (auto& buffer : _shader_buffers) {
+			techniques.push_back(buffer.technique);
+		}
+		for (auto& technique : techniques) {
+			auto etech = _shader.get_technique(technique);
+			for (std::size_t idx = 0; idx < etech.count_passes(); idx++) {
+				auto pass = etech.get_pass(idx);
 
-			for (std::size_t vidx = 0; vidx < pass.count_vertex_parameters(); vidx++) {
-				auto el = pass.get_vertex_parameter(vidx);
+				for (std::size_t vidx = 0; vidx < pass.count_vertex_parameters(); vidx++) {
+					auto el = pass.get_vertex_parameter(vidx);
 
-				if (!el)
-					continue;
+					if (!el || is_input_parameter(el))
+						continue;
 
-				auto fnd = _shader_params.find(el.get_name());
-				if (fnd != _shader_params.end())
-					continue;
+					auto fnd = _shader_params.find(el.get_name());
+					if (fnd != _shader_params.end())
+						continue;
 
-				auto param = gfx::shader::parameter::make_parameter(el, ST_PARAMETERS);
+					auto param = gfx::shader::parameter::make_parameter(el, ST_PARAMETERS, _self);
 
-				if (param) {
-					_shader_params.insert_or_assign(el.get_name(), param);
-					param->defaults(settings.get());
-					param->update(settings.get());
+					if (param) {
+						_shader_params.insert_or_assign(el.get_name(), param);
+						param->defaults(settings.get());
+						param->update(settings.get());
+					}
 				}
-			}
 
-			for (std::size_t vidx = 0; vidx < pass.count_pixel_parameters(); vidx++) {
-				auto el = pass.get_pixel_parameter(vidx);
+				for (std::size_t vidx = 0; vidx < pass.count_pixel_parameters(); vidx++) {
+					auto el = pass.get_pixel_parameter(vidx);
 
-				if (!el)
-					continue;
+					if (!el || is_input_parameter(el))
+						continue;
 
-				auto fnd = _shader_params.find(el.get_name());
-				if (fnd != _shader_params.end())
-					continue;
+					auto fnd = _shader_params.find(el.get_name());
+					if (fnd != _shader_params.end())
+						continue;
 
-				auto param = gfx::shader::parameter::make_parameter(el, ST_PARAMETERS);
+					auto param = gfx::shader::parameter::make_parameter(el, ST_PARAMETERS, _self);
 
-				if (param) {
-					_shader_params.insert_or_assign(el.get_name(), param);
-					param->defaults(settings.get());
-					param->update(settings.get());
+					if (param) {
+						_shader_params.insert_or_assign(el.get_name(), param);
+						param->defaults(settings.get());
+						param->update(settings.get());
+					}
 				}
 			}
 		}
+
+		// Pack the values of all basic parameters into one contiguous block, instead of one allocation each.
+		std::size_t values = 0;
+		for (auto kv : _shader_params) {
+			if (auto param = std::dynamic_pointer_cast<basic_parameter>(kv.second); param)
+				values += param->get_size();
+		}
+		_shader_values.assign(values, basic_data{});
+		std::size_t offset = 0;
+		for (auto kv : _shader_params) {
+			if (auto param = std::dynamic_pointer_cast<basic_parameter>(kv.second); param) {
+				param->bind(_shader_values.data() + offset);
+				offset += param->get_size();
+			}
+		}
 	}
 
+	if (shader_dirty || param_dirty)
+		invalidate();
+
 	return true;
 } catch (const std::exception& ex) {
 	DLOG_ERROR("Loading shader '%s' failed with error: %s", file.c_str(), ex.what());
@@ -371,6 +495,8 @@ void gfx::shader::shader::update(obs_data_t* data)
 	for (auto kv : _shader_params) {
 		kv.second->update(data);
 	}
+
+	invalidate();
 }
 
 uint32_t gfx::shader::shader::width()
@@ -433,11 +559,14 @@ uint32_t gfx::shader::shader::base_height()
 
 bool gfx::shader::shader::tick(float_t time)
 {
-	_shader_file_tick = static_cast<float_t>(static_cast<double_t>(_shader_file_tick) + static_cast<double_t>(time));
-	if (_shader_file_tick >= 1.0f / 3.0f) {
-		_shader_file_tick -= 1.0f / 3.0f;
-		bool v1, v2;
-		load_shader(_shader_file, _shader_tech, v1, v2);
+	// Pick up changes to the shader file, which are read in the background and compiled here. Compiling blocks
+	// rendering until it is done.
+	if (_shader_effect_file) {
+		_shader_effect_file->update();
+		if (_shader_effect_file->get_generation() != _shader_generation) {
+			bool v1, v2;
+			load_shader(_shader_file, _shader_tech, v1, v2);
+		}
 	}
 
 	// Update State
@@ -458,8 +587,30 @@ bool gfx::shader::shader::tick(float_t time)
 			static_cast<float_t>(static_cast<double_t>(_random()) / static_cast<double_t>(_random.max()));
 	}
 
-	// Flag Render Target as outdated.
-	_rt_up_to_date = false;
+	// Figure out if the output only depends on the settings, in which case it can be kept until they change. This is
+	// checked every frame, as parameters may stop being dynamic (e.g. once an image has finished loading).
+	_shader_static = _shader && _history_params.empty()
+					 && !(_param_time || _param_random || _param_input_a || _param_input_b || _param_transition_time);
+	for (auto kv : _shader_params) {
+		_shader_static = _shader_static && !kv.second->is_dynamic();
+	}
+
+	// Static output is always cached, and so is output that is kept as history. Otherwise only cache the output if it
+	// was drawn more than once last frame, as the copy would cost more than it saves.
+	_rt_cache   = _shader_static || !_history_params.empty() || (_rt_renders > 1);
+	_rt_renders = 0;
+
+	// Keep the last output as history. The next one is rendered into a new target from the pool.
+	if (!_history_params.empty() && _rt_up_to_date) {
+		_history.push_front(_rt);
+		while (_history.size() > _history_params.size()) {
+			_history.pop_back();
+		}
+	}
+
+	// Flag Render Target as outdated, unless nothing but a settings change can alter it.
+	if (!_shader_static)
+		_rt_up_to_date = false;
 
 	return false;
 }
@@ -469,68 +620,100 @@ void gfx::shader::shader::prepare_render()
 	if (!_shader)
 		return;
 
+	// Nothing to do if the cached output will be used.
+	if (_rt_cache && _rt_up_to_date)
+		return;
+
 	// Assign user parameters
 	for (auto kv : _shader_params) {
 		kv.second->assign();
 	}
 
 	// float4 Time: (Time in Seconds), (Time in Current Second), (Time in Seconds only), (Random Value)
-	if (gs::effect_parameter el = _shader.get_parameter("Time"); el != nullptr) {
-		if (el.get_type() == gs::effect_parameter::type::Float4) {
-			el.set_float4(
-				_time, _time_loop, static_cast<float_t>(_loops),
-				static_cast<float_t>(static_cast<double_t>(_random()) / static_cast<double_t>(_random.max())));
-		}
+	if (_param_time) {
+		_param_time.set_float4(
+			_time, _time_loop, static_cast<float_t>(_loops),
+			static_cast<float_t>(static_cast<double_t>(_random()) / static_cast<double_t>(_random.max())));
 	}
 
 	// float4 ViewSize: (Width), (Height), (1.0 / Width), (1.0 / Height)
-	if (auto el = _shader.get_parameter("ViewSize"); el != nullptr) {
-		if (el.get_type() == gs::effect_parameter::type::Float4) {
-			el.set_float4(static_cast<float_t>(width()), static_cast<float_t>(height()),
-						  1.0f / static_cast<float_t>(width()), 1.0f / static_cast<float_t>(height()));
-		}
+	if (_param_view_size) {
+		_param_view_size.set_float4(static_cast<float_t>(width()), static_cast<float_t>(height()),
+									1.0f / static_cast<float_t>(width()), 1.0f / static_cast<float_t>(height()));
 	}
 
 	// float4x4 Random: float4[Per-Instance Random], float4[Per-Activation Random], float4x2[Per-Frame Random]
-	if (auto el = _shader.get_parameter("Random"); el != nullptr) {
-		if (el.get_type() == gs::effect_parameter::type::Matrix) {
-			el.set_value(_random_values, 16);
-		}
+	if (_param_random) {
+		_param_random.set_value(_random_values, 16);
 	}
 
 	// int32 RandomSeed: Seed used for random generation
-	if (auto el = _shader.get_parameter("RandomSeed"); el != nullptr) {
-		if (el.get_type() == gs::effect_parameter::type::Integer) {
-			el.set_int(_random_seed);
-		}
+	if (_param_random_seed) {
+		_param_random_seed.set_int(_random_seed);
 	}
 
 	return;
 }
 
+static bool is_output_unscaled()
+{
+	// libobs can't tell us the current projection, so assume it covers the viewport in pixels, which is what every
+	// render into a texture sets up. The output then maps 1:1 to pixels if the viewport covers the entire target, and
+	// the world transform neither scales nor rotates.
+	gs_texture_t* target = gs_get_render_target();
+	gs_rect       viewport;
+	gs_get_viewport(&viewport);
+	if (!target || (viewport.x != 0) || (viewport.y != 0)
+		|| (static_cast<uint32_t>(viewport.cx) != gs_texture_get_width(target))
+		|| (static_cast<uint32_t>(viewport.cy) != gs_texture_get_height(target)))
+		return false;
+
+	constexpr float_t epsilon = 1.0f / 65536.0f;
+	matrix4           world;
+	gs_matrix_get(&world);
+	return (std::abs(world.x.x - 1.0f) < epsilon) && (std::abs(world.y.y - 1.0f) < epsilon)
+		   && (std::abs(world.x.y) < epsilon) && (std::abs(world.y.x) < epsilon);
+}
+
 void gfx::shader::shader::render()
 {
 	if (!_shader)
 		return;
 
-	if (!_rt_up_to_date) {
-		auto op   = _rt->render(width(), height());
-		vec4 zero = {0, 0, 0, 0};
-		gs_ortho(0, 1, 0, 1, 0, 1);
-		gs_clear(GS_CLEAR_COLOR, &zero, 0, 0);
+	_rt_renders++;
+	if (!_rt_cache && is_output_unscaled()) {
+		render_buffers();
 
-		gs_blend_state_push();
-		gs_reset_blend_state();
-
-		gs_enable_blending(true);
-		gs_blend_function_separate(GS_BLEND_ONE, GS_BLEND_ZERO, GS_BLEND_ONE, GS_BLEND_ZERO);
-		gs_enable_color(true, true, true, true);
+		// Draw straight into the current target, which saves a full copy of the output. Scaled output still goes
+		// through _rt, so that the shader runs at its own size and ViewSize stays correct.
 		while (gs_effect_loop(_shader.get_object(), _shader_tech.c_str())) {
-			streamfx::gs_draw_fullscreen_tri();
+			gs_draw_sprite(nullptr, 0, width(), height());
 		}
 
-		gs_blend_state_pop();
+		release_buffers();
+		return;
+	}
+
+	if (!_rt_up_to_date) {
+		if (!_history_params.empty()) {
+			_rt = gfx::rendertarget_pool::get()->acquire(GS_RGBA, width(), height());
+			for (std::size_t idx = 0; idx < _history_params.size(); idx++) {
+				if (idx < _history.size()) {
+					_history_params[idx].set_texture(_history[idx]->get_texture());
+				} else {
+					_history_params[idx].set_texture(static_cast<gs_texture_t*>(nullptr));
+				}
+			}
+		}
+
+		render_buffers();
+
+		{
+			auto op = _rt->render(width(), height());
+			draw_technique(_shader_tech);
+		}
 
+		release_buffers();
 		_rt_up_to_date = true;
 	}
 
@@ -541,73 +724,102 @@ void gfx::shader::shader::render()
 	}
 }
 
-void gfx::shader::shader::set_size(uint32_t w, uint32_t h)
+void gfx::shader::shader::invalidate()
 {
-	_base_width  = w;
-	_base_height = h;
+	_rt_up_to_date = false;
 }
 
-void gfx::shader::shader::set_input_a(std::shared_ptr<gs::texture> tex)
+void gfx::shader::shader::render_buffers()
 {
-	if (!_shader)
+	if (_shader_buffers.empty())
 		return;
 
-	std::string_view params[] = {
-		"InputA",
-		"image",
-		"tex_a",
-	};
-	for (auto& name : params) {
-		if (gs::effect_parameter el = _shader.get_parameter(name.data()); el != nullptr) {
-			if (el.get_type() == gs::effect_parameter::type::Texture) {
-				el.set_texture(tex);
-				break;
-			}
+	for (auto& buffer : _shader_buffers) {
+#ifdef ENABLE_PROFILING
+		auto cctr = gs::debug_marker(gs::debug_color_render, "Buffer '%s'", buffer.param.get_name().data());
+#endif
+		uint32_t w = std::max(static_cast<uint32_t>(width() * buffer.scale), 1u);
+		uint32_t h = std::max(static_cast<uint32_t>(height() * buffer.scale), 1u);
+
+		// ViewSize describes the buffer while it is being rendered.
+		if (_param_view_size) {
+			_param_view_size.set_float4(static_cast<float_t>(w), static_cast<float_t>(h),
+										1.0f / static_cast<float_t>(w), 1.0f / static_cast<float_t>(h));
 		}
+
+		// Buffers are only needed until the main technique has been drawn, see release_buffers().
+		buffer.rt = gfx::rendertarget_pool::get()->acquire(buffer.format, w, h);
+		{
+			auto op = buffer.rt->render(w, h);
+			draw_technique(buffer.technique);
+		}
+		buffer.param.set_texture(buffer.rt->get_texture());
+	}
+
+	if (_param_view_size) {
+		_param_view_size.set_float4(static_cast<float_t>(width()), static_cast<float_t>(height()),
+									1.0f / static_cast<float_t>(width()), 1.0f / static_cast<float_t>(height()));
 	}
 }
 
-void gfx::shader::shader::set_input_b(std::shared_ptr<gs::texture> tex)
+void gfx::shader::shader::release_buffers()
 {
-	if (!_shader)
-		return;
-
-	std::string_view params[] = {
-		"InputB",
-		"image2",
-		"tex_b",
-	};
-	for (auto& name : params) {
-		if (gs::effect_parameter el = _shader.get_parameter(name.data()); el != nullptr) {
-			if (el.get_type() == gs::effect_parameter::type::Texture) {
-				el.set_texture(tex);
-				break;
-			}
-		}
+	// Return the buffers to the pool, so that other shaders can use them for the rest of the frame.
+	for (auto& buffer : _shader_buffers) {
+		buffer.rt.reset();
 	}
 }
 
-void gfx::shader::shader::set_transition_time(float_t t)
+void gfx::shader::shader::draw_technique(const std::string& technique)
 {
-	if (!_shader)
-		return;
+	vec4 zero = {0, 0, 0, 0};
+	gs_ortho(0, 1, 0, 1, 0, 1);
+	gs_clear(GS_CLEAR_COLOR, &zero, 0, 0);
 
-	if (gs::effect_parameter el = _shader.get_parameter("TransitionTime"); el != nullptr) {
-		if (el.get_type() == gs::effect_parameter::type::Float) {
-			el.set_float(t);
-		}
+	gs_blend_state_push();
+	gs_reset_blend_state();
+
+	gs_enable_blending(true);
+	gs_blend_function_separate(GS_BLEND_ONE, GS_BLEND_ZERO, GS_BLEND_ONE, GS_BLEND_ZERO);
+	gs_enable_color(true, true, true, true);
+	while (gs_effect_loop(_shader.get_object(), technique.c_str())) {
+		streamfx::gs_draw_fullscreen_tri();
 	}
+
+	gs_blend_state_pop();
+}
+
+void gfx::shader::shader::set_size(uint32_t w, uint32_t h)
+{
+	if ((_base_width != w) || (_base_height != h))
+		invalidate();
+
+	_base_width  = w;
+	_base_height = h;
+}
+
+void gfx::shader::shader::set_input_a(std::shared_ptr<gs::texture> tex)
+{
+	if (_shader && _param_input_a)
+		_param_input_a.set_texture(tex);
+}
+
+void gfx::shader::shader::set_input_b(std::shared_ptr<gs::texture> tex)
+{
+	if (_shader && _param_input_b)
+		_param_input_b.set_texture(tex);
+}
+
+void gfx::shader::shader::set_transition_time(float_t t)
+{
+	if (_shader && _param_transition_time)
+		_param_transition_time.set_float(t);
 }
 
 void gfx::shader::shader::set_transition_size(uint32_t w, uint32_t h)
 {
-	if (!_shader)
-		return;
-	if (gs::effect_parameter el = _shader.get_parameter("TransitionSize"); el != nullptr) {
-		if (el.get_type() == gs::effect_parameter::type::Integer2) {
-			el.set_int2(static_cast<int32_t>(w), static_cast<int32_t>(h));
-		}
-	}
+	if (_shader && _param_transition_size)
+		_param_transition_size.set_int2(static_cast<int32_t>(w), static_cast<int32_t>(h));
 }
 
 void gfx::shader::shader::set_active(bool active)
@@ -18,9 +18,12 @@
 #pragma once
 #include "common.hpp"
 #include <filesystem>
+#include <deque>
 #include <list>
 #include <map>
 #include <random>
+#include "gfx/shader/gfx-shader-effect-file.hpp"
+#include "gfx/shader/gfx-shader-param-basic.hpp"
 #include "gfx/shader/gfx-shader-param.hpp"
 #include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
@@ -40,6 +43,19 @@ namespace gfx {
 
 		typedef std::map<std::string_view, std::shared_ptr<parameter>> shader_param_map_t;
 
+		/** Intermediate buffer declared by a shader, which is rendered with its own technique before the main one.
+		 *
+		 * Declared as a texture parameter with the annotations 'type = "buffer"', 'technique' (required), 'scale'
+		 * (relative to the output size, default 1.0) and 'format' ("rgba", "rgba16f" or "rgba32f").
+		 */
+		struct shader_buffer {
+			gs::effect_parameter              param;
+			std::string                       technique;
+			double_t                          scale;
+			gs_color_format                   format;
+			std::shared_ptr<gs::rendertarget> rt;
+		};
+
 		class shader {
 			obs_source_t* _self;
 
@@ -50,13 +66,29 @@ namespace gfx {
 			bool        _active;
 
 			// Shader
-			gs::effect                      _shader;
-			std::filesystem::path           _shader_file;
-			std::string                     _shader_tech;
-			std::filesystem::file_time_type _shader_file_mt;
-			uintmax_t                       _shader_file_sz;
-			float_t                         _shader_file_tick;
-			shader_param_map_t              _shader_params;
+			gs::effect                   _shader;
+			std::filesystem::path        _shader_file;
+			std::shared_ptr<effect_file> _shader_effect_file;
+			uint64_t                     _shader_generation;
+			std::string                  _shader_tech;
+			shader_param_map_t           _shader_params;
+			std::vector<shader_buffer>   _shader_buffers;
+			std::vector<basic_data>      _shader_values; // Packed values of all basic parameters.
+			bool                         _shader_static; // Output only changes when settings change.
+
+			// Built-in parameters, resolved once per loaded shader.
+			gs::effect_parameter _param_time;
+			gs::effect_parameter _param_view_size;
+			gs::effect_parameter _param_random;
+			gs::effect_parameter _param_random_seed;
+			gs::effect_parameter _param_input_a;
+			gs::effect_parameter _param_input_b;
+			gs::effect_parameter _param_transition_time;
+			gs::effect_parameter _param_transition_size;
+
+			// History, exposed as PreviousFrame (last output) and PreviousFrame2 to PreviousFrame8 (older outputs).
+			std::vector<gs::effect_parameter>             _history_params;
+			std::deque<std::shared_ptr<gs::rendertarget>> _history; // Most recent output first.
 
 			// Options
 			size_type _width_type;
@@ -76,6 +108,8 @@ namespace gfx {
 			// Rendering
 			bool                              _rt_up_to_date;
 			std::shared_ptr<gs::rendertarget> _rt;
+			uint32_t                          _rt_renders; // Render calls since the last tick.
+			bool                              _rt_cache;   // Render through _rt instead of directly.
 
 			public:
 			shader(obs_source_t* self, shader_mode mode);
@@ -85,6 +119,8 @@ namespace gfx {
 
 			bool is_technique_different(const std::string& tech);
 
+			bool is_input_parameter(gs::effect_parameter& param);
+
 			bool load_shader(const std::filesystem::path& file, const std::string& tech, bool& shader_dirty,
 							 bool& param_dirty);
 
@@ -114,6 +150,15 @@ namespace gfx {
 
 			void render();
 
+			void invalidate();
+
+			private:
+			void render_buffers();
+
+			void release_buffers();
+
+			void draw_technique(const std::string& technique);
+
 			public:
 			void set_size(uint32_t w, uint32_t h);
 
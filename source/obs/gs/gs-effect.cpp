@@ -125,6 +125,13 @@ gs::effect_parameter gs::effect::get_parameter(const std::string& name)
 	return nullptr;
 }
 
+gs::effect_parameter gs::effect::get_parameter(const std::string& name, effect_parameter::type type)
+{
+	if (auto eprm = get_parameter(name); eprm && (eprm.get_type() == type))
+		return eprm;
+	return nullptr;
+}
+
 bool gs::effect::has_parameter(const std::string& name)
 {
 	if (get_parameter(name))
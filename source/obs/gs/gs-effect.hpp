@@ -28,6 +28,7 @@ namespace gs {
 	class effect : public std::shared_ptr<gs_effect_t> {
 		public:
 		effect(){};
+		effect(std::shared_ptr<gs_effect_t> effect) : std::shared_ptr<gs_effect_t>(effect){};
 		effect(const std::string& code, const std::string& name);
 		effect(std::filesystem::path file);
 		~effect();
@@ -40,6 +41,7 @@ namespace gs {
 		std::size_t          count_parameters();
 		gs::effect_parameter get_parameter(std::size_t idx);
 		gs::effect_parameter get_parameter(const std::string& name);
+		gs::effect_parameter get_parameter(const std::string& name, effect_parameter::type type);
 		bool                 has_parameter(const std::string& name);
 		bool                 has_parameter(const std::string& name, effect_parameter::type type);
 
@@ -47,8 +47,11 @@ try {
 
 	{
 		std::unique_lock<std::mutex> ul(self->_lock);
-		self->_sources.insert({std::string(name), {weak, obs::obs_weak_source_deleter}});
+		self->insert(name, {{weak, obs::obs_weak_source_deleter},
+							obs_source_get_type(target),
+							obs_source_get_output_flags(target)});
 	}
+	self->events.create(name);
 } catch (...) {
 	DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 }
@@ -71,12 +74,11 @@ try {
 
 	{
 		std::unique_lock<std::mutex> ul(self->_lock);
-		auto                         found = self->_sources.find(std::string(name));
-		if (found == self->_sources.end()) {
+		if (!self->erase(name)) {
 			return;
 		}
-		self->_sources.erase(found);
 	}
+	self->events.destroy(name);
 } catch (...) {
 	DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 }
@@ -106,14 +108,17 @@ try {
 			if (!weak) {
 				return;
 			}
-			self->_sources.insert({new_name, {weak, obs::obs_weak_source_deleter}});
-			return;
+			self->insert(new_name, {{weak, obs::obs_weak_source_deleter},
+									obs_source_get_type(target),
+									obs_source_get_output_flags(target)});
+		} else {
+			// Insert at new key, remove old pair.
+			source_entry entry = found->second;
+			self->erase(prev_name);
+			self->insert(new_name, entry);
 		}
-
-		// Insert at new key, remove old pair.
-		self->_sources.insert({new_name, found->second});
-		self->_sources.erase(found);
 	}
+	self->events.rename(prev_name, new_name);
 } catch (...) {
 	DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 }
@@ -133,8 +138,82 @@ std::shared_ptr<obs::source_tracker> obs::source_tracker::get()
 	return source_tracker_instance;
 }
 
-obs::source_tracker::source_tracker()
+void obs::source_tracker::insert(std::string name, source_entry entry)
+{
+	// Only the views of indexes the source is part of are thrown away, all others stay valid.
+	for (auto& kv : _indexes) {
+		if (is_indexed(kv.first, entry)) {
+			kv.second.insert(name);
+			_views.erase(kv.first);
+		}
+	}
+	_sources.insert_or_assign(name, entry);
+	_generation++;
+}
+
+bool obs::source_tracker::erase(std::string name)
+{
+	auto found = _sources.find(name);
+	if (found == _sources.end()) {
+		return false;
+	}
+
+	for (auto& kv : _indexes) {
+		if (is_indexed(kv.first, found->second)) {
+			kv.second.erase(name);
+			_views.erase(kv.first);
+		}
+	}
+	_sources.erase(found);
+	_generation++;
+	return true;
+}
+
+std::shared_ptr<const obs::source_tracker::view_t> obs::source_tracker::get_view(index idx)
+{
+	std::unique_lock<std::mutex> ul(_lock);
+
+	if (auto kv = _views.find(idx); kv != _views.end()) {
+		return kv->second;
+	}
+
+	// Rebuild the view from the (already sorted) index.
+	auto  view  = std::make_shared<view_t>();
+	auto& names = _indexes[idx];
+	view->reserve(names.size());
+	for (auto& name : names) {
+		view->emplace_back(name, _sources.at(name).weak);
+	}
+	_views[idx] = view;
+	return view;
+}
+
+bool obs::source_tracker::is_indexed(index idx, const source_entry& entry)
 {
+	switch (idx) {
+	case index::All:
+		return true;
+	case index::Sources:
+		return (entry.type == OBS_SOURCE_TYPE_INPUT);
+	case index::AudioSources:
+		return (entry.type == OBS_SOURCE_TYPE_INPUT) && (entry.flags & OBS_SOURCE_AUDIO);
+	case index::VideoSources:
+		return (entry.type == OBS_SOURCE_TYPE_INPUT) && (entry.flags & OBS_SOURCE_VIDEO);
+	case index::Transitions:
+		return (entry.type == OBS_SOURCE_TYPE_TRANSITION);
+	case index::Scenes:
+		return (entry.type == OBS_SOURCE_TYPE_SCENE);
+	}
+	return false;
+}
+
+obs::source_tracker::source_tracker() : _sources(), _indexes(), _views(), _generation(0), _lock()
+{
+	for (auto idx : {index::All, index::Sources, index::AudioSources, index::VideoSources, index::Transitions,
+					 index::Scenes}) {
+		_indexes[idx];
+	}
+
 	auto osi = obs_get_signal_handler();
 	signal_handler_connect(osi, "source_create", &source_create_handler, this);
 	signal_handler_connect(osi, "source_destroy", &source_destroy_handler, this);
@@ -150,19 +229,22 @@ obs::source_tracker::~source_tracker()
 		signal_handler_disconnect(osi, "source_rename", &source_rename_handler, this);
 	}
 
+	this->_views.clear();
+	this->_indexes.clear();
 	this->_sources.clear();
 }
 
 void obs::source_tracker::enumerate(enumerate_cb_t ecb, filter_cb_t fcb)
 {
-	// Need func-local copy, otherwise we risk corruption if a new source is created or destroyed.
-	decltype(_sources) _clone;
-	{
-		std::unique_lock<std::mutex> ul(_lock);
-		_clone = _sources;
-	}
+	enumerate(ecb, index::All, fcb);
+}
+
+void obs::source_tracker::enumerate(enumerate_cb_t ecb, index idx, filter_cb_t fcb)
+{
+	// Views are immutable snapshots, so holding on to one is safe even if a source is created or destroyed.
+	auto view = get_view(idx);
 
-	for (auto kv : _clone) {
+	for (auto& kv : *view) {
 		auto source =
 			std::shared_ptr<obs_source_t>(obs_weak_source_get_source(kv.second.get()), obs::obs_source_deleter);
 		if (!source) {
@@ -183,6 +265,25 @@ void obs::source_tracker::enumerate(enumerate_cb_t ecb, filter_cb_t fcb)
 	}
 }
 
+std::shared_ptr<obs_source_t> obs::source_tracker::find(std::string name)
+{
+	std::shared_ptr<obs_weak_source_t> weak;
+	{
+		std::unique_lock<std::mutex> ul(_lock);
+		auto                         found = _sources.find(name);
+		if (found == _sources.end()) {
+			return nullptr;
+		}
+		weak = found->second.weak;
+	}
+	return std::shared_ptr<obs_source_t>(obs_weak_source_get_source(weak.get()), obs::obs_source_deleter);
+}
+
+uint64_t obs::source_tracker::get_generation()
+{
+	return _generation.load();
+}
+
 bool obs::source_tracker::filter_sources(std::string, obs_source_t* source)
 {
 	return (obs_source_get_type(source) != OBS_SOURCE_TYPE_INPUT);
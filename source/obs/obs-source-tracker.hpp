@@ -19,14 +19,49 @@
 
 #pragma once
 #include "common.hpp"
+#include <atomic>
 #include <functional>
 #include <map>
 #include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "util/util-event.hpp"
 
 namespace obs {
 	class source_tracker {
-		std::map<std::string, std::shared_ptr<obs_weak_source_t>> _sources;
-		std::mutex                                                _lock;
+		public:
+		// Pre-filtered sets of sources which are kept up to date as sources come and go.
+		enum class index : uint8_t {
+			All,
+			Sources,
+			AudioSources,
+			VideoSources,
+			Transitions,
+			Scenes,
+		};
+
+		private:
+		struct source_entry {
+			std::shared_ptr<obs_weak_source_t> weak;
+			obs_source_type                    type;
+			uint32_t                           flags;
+		};
+
+		typedef std::vector<std::pair<std::string, std::shared_ptr<obs_weak_source_t>>> view_t;
+
+		std::unordered_map<std::string, source_entry>  _sources;
+		std::map<index, std::set<std::string>>         _indexes;
+		std::map<index, std::shared_ptr<const view_t>> _views;
+		std::atomic<uint64_t>                          _generation;
+		std::mutex                                     _lock;
+
+		void insert(std::string name, source_entry entry);
+		bool erase(std::string name);
+
+		std::shared_ptr<const view_t> get_view(index idx);
+
+		static bool is_indexed(index idx, const source_entry& entry);
 
 		static void source_create_handler(void* ptr, calldata_t* data) noexcept;
 		static void source_destroy_handler(void* ptr, calldata_t* data) noexcept;
@@ -62,6 +97,30 @@ namespace obs {
 		// @param filter_cb Filter function to narrow down results.
 		void enumerate(enumerate_cb_t enumerate_cb, filter_cb_t filter_cb = nullptr);
 
+		//! Enumerate all tracked sources in an index
+		//
+		// Much cheaper than a filter function, as the result is cached until a source in the index changes.
+		//
+		// @param enumerate_cb The function called for each tracked source.
+		// @param idx The index to enumerate.
+		// @param filter_cb Filter function to narrow down results further.
+		void enumerate(enumerate_cb_t enumerate_cb, index idx, filter_cb_t filter_cb = nullptr);
+
+		//! Find a tracked source by name
+		//
+		// @return The source, or nullptr if there is no such source.
+		std::shared_ptr<obs_source_t> find(std::string name);
+
+		//! Incremented every time a source is created, destroyed or renamed.
+		uint64_t get_generation();
+
+		public: // Events
+		struct {
+			util::event<std::string>              create;
+			util::event<std::string>              destroy;
+			util::event<std::string, std::string> rename;
+		} events;
+
 		public:
 		static bool filter_sources(std::string name, obs_source_t* source);
 		static bool filter_audio_sources(std::string name, obs_source_t* source);
@@ -34,7 +34,7 @@ try {
 		self->_self = nullptr;
 	}
 
-	if (self->events.destroy) {
+	if (!self->events.destroy) {
 		return;
 	}
 	self->events.destroy(self);
@@ -689,12 +689,12 @@ obs::deprecated_source& obs::deprecated_source::operator=(deprecated_source cons
 }
 */
 
-obs::deprecated_source::deprecated_source(deprecated_source&& other)
-	: _self(std::move(other._self)), _track_ownership(std::move(other._track_ownership))
+obs::deprecated_source::deprecated_source(deprecated_source&& other) : ::obs::deprecated_source::deprecated_source()
 {
-	// Clean out other source
-	other._self            = nullptr;
-	other._track_ownership = false;
+	// Take over the source first, so that moving the events below disconnects the signals from the other source
+	// object and connects them to this one.
+	_self            = other._self;
+	_track_ownership = other._track_ownership;
 
 #ifdef auto_signal_c
 #undef auto_signal_c
@@ -728,23 +728,57 @@ obs::deprecated_source::deprecated_source(deprecated_source&& other)
 	auto_signal_c(transition_video_stop);
 	auto_signal_c(transition_stop);
 #undef auto_signal_c
+
+	// Clean out other source
+	other._self            = nullptr;
+	other._track_ownership = false;
 }
 
 obs::deprecated_source& obs::deprecated_source::operator=(deprecated_source&& other)
 {
-	if (this != &other) {
+	if (this == &other) {
 		return *this;
 	}
 
-	// Release previous source.
+	// Disconnect from the previous source, then release it.
+#ifdef auto_signal_c
+#undef auto_signal_c
+#endif
+#define auto_signal_c(SIGNAL) this->events.SIGNAL.clear()
+	auto_signal_c(destroy);
+	auto_signal_c(remove);
+	auto_signal_c(save);
+	auto_signal_c(load);
+	auto_signal_c(activate);
+	auto_signal_c(deactivate);
+	auto_signal_c(show);
+	auto_signal_c(hide);
+	auto_signal_c(mute);
+	auto_signal_c(push_to_mute_changed);
+	auto_signal_c(push_to_mute_delay);
+	auto_signal_c(push_to_talk_changed);
+	auto_signal_c(push_to_talk_delay);
+	auto_signal_c(enable);
+	auto_signal_c(rename);
+	auto_signal_c(volume);
+	auto_signal_c(update_properties);
+	auto_signal_c(update_flags);
+	auto_signal_c(audio_sync);
+	auto_signal_c(audio_mixers);
+	auto_signal_c(audio);
+	auto_signal_c(filter_add);
+	auto_signal_c(filter_remove);
+	auto_signal_c(reorder_filters);
+	auto_signal_c(transition_start);
+	auto_signal_c(transition_video_stop);
+	auto_signal_c(transition_stop);
+#undef auto_signal_c
 	if (this->_self && this->_track_ownership) {
 		obs_source_release(this->_self);
 	}
 
-	this->_self            = std::move(other._self);
-	this->_track_ownership = std::move(other._track_ownership);
-	other._self            = nullptr;
-	other._track_ownership = false;
+	this->_self            = other._self;
+	this->_track_ownership = other._track_ownership;
 
 #ifdef auto_signal_c
 #undef auto_signal_c
@@ -779,6 +813,9 @@ obs::deprecated_source& obs::deprecated_source::operator=(deprecated_source&& ot
 	auto_signal_c(transition_stop);
 #undef auto_signal_c
 
+	other._self            = nullptr;
+	other._track_ownership = false;
+
 	return *this;
 }
 
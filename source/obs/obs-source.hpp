@@ -23,7 +23,7 @@
 
 namespace obs {
 	class deprecated_source {
-		obs_source_t* _self;
+		obs_source_t* _self            = nullptr;
 		bool          _track_ownership = false;
 
 		static void handle_destroy(void* p, calldata_t* calldata) noexcept;
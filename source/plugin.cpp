@@ -21,8 +21,12 @@
 #include <fstream>
 #include <stdexcept>
 #include "configuration.hpp"
+#include "gfx/gfx-effect-registry.hpp"
+#include "gfx/gfx-rendertarget-pool.hpp"
+#include "gfx/gfx-texture-loader.hpp"
 #include "obs/gs/gs-vertexbuffer.hpp"
 #include "obs/obs-source-tracker.hpp"
+#include "util/util-file-watcher.hpp"
 
 #ifdef ENABLE_ENCODER_FFMPEG
 #include "encoders/encoder-ffmpeg.hpp"
@@ -70,6 +74,7 @@
 
 #ifdef ENABLE_UPDATER
 #include "updater.hpp"
+#include "util/util-curl.hpp"
 //static std::shared_ptr<streamfx::updater> _updater;
 #endif
 
@@ -86,9 +91,26 @@ try {
 	// Initialize global Thread Pool.
 	_threadpool = std::make_shared<util::threadpool>();
 
+	// Initialize File Watcher
+	util::file_watcher::initialize();
+
+#ifdef ENABLE_UPDATER
+	// Initialize HTTP Client
+	util::curl_client::initialize();
+#endif
+
 	// Initialize Source Tracker
 	obs::source_tracker::initialize();
 
+	// Initialize Effect Registry
+	gfx::effect_registry::initialize();
+
+	// Initialize Texture Loader
+	gfx::texture_loader::initialize();
+
+	// Initialize Render Target Pool
+	gfx::rendertarget_pool::initialize();
+
 	// GS Stuff
 	{
 		_gs_fstri_vb = std::make_shared<gs::vertex_buffer>(uint32_t(3), uint8_t(1));
@@ -241,6 +263,15 @@ try {
 		_gs_fstri_vb.reset();
 	}
 
+	// Finalize Render Target Pool
+	gfx::rendertarget_pool::finalize();
+
+	// Finalize Texture Loader
+	gfx::texture_loader::finalize();
+
+	// Finalize Effect Registry
+	gfx::effect_registry::finalize();
+
 	// Finalize Source Tracker
 	obs::source_tracker::finalize();
 
@@ -249,6 +280,14 @@ try {
 	//	_updater.reset();
 	//#endif
 
+#ifdef ENABLE_UPDATER
+	// Finalize HTTP Client
+	util::curl_client::finalize();
+#endif
+
+	// Finalize File Watcher
+	util::file_watcher::finalize();
+
 	// Finalize Thread Pool
 	_threadpool.reset();
 
@@ -19,7 +19,9 @@
 
 #include "source-mirror.hpp"
 #include "strings.hpp"
+#include <algorithm>
 #include <bitset>
+#include <cinttypes>
 #include <cstring>
 #include <functional>
 #include <memory>
@@ -45,36 +47,264 @@
 #define ST_SOURCE_AUDIO ST_SOURCE ".Audio"
 #define ST_SOURCE_AUDIO_LAYOUT ST_SOURCE_AUDIO ".Layout"
 #define ST_SOURCE_AUDIO_LAYOUT_(x) ST_SOURCE_AUDIO_LAYOUT "." D_VSTR(x)
+#define ST_SOURCE_AUDIO_ONLY ST_SOURCE_AUDIO ".Only"
+#define ST_SOURCE_AUDIO_MIX ST_SOURCE_AUDIO ".Mix"
+#define ST_SOURCE_AUDIO_MIX_NONE ST_SOURCE_AUDIO_MIX ".None"
+#define ST_CACHE ST ".Cache"
+#define ST_CACHE_SCALE ST_CACHE ".Scale"
+#define ST_CACHE_CROP ST_CACHE ".Crop"
+#define ST_CACHE_CROP_LEFT ST_CACHE_CROP ".Left"
+#define ST_CACHE_CROP_TOP ST_CACHE_CROP ".Top"
+#define ST_CACHE_CROP_RIGHT ST_CACHE_CROP ".Right"
+#define ST_CACHE_CROP_BOTTOM ST_CACHE_CROP ".Bottom"
 
 using namespace streamfx::source::mirror;
 
-mirror_audio_data::mirror_audio_data(const audio_data* audio, speaker_layout layout)
+// Number of blocks in the audio ring, each holding up to AUDIO_OUTPUT_FRAMES frames.
+#define AUDIO_BLOCKS 64
+
+// -3dB, used when a speaker is spread over (or folded from) two others.
+#define AUDIO_MIX_HALF_POWER 0.70710678f
+
+enum class speaker : uint8_t { FL, FR, FC, LFE, RL, RR, RC, SL, SR };
+
+static std::vector<speaker> get_speakers(speaker_layout layout)
 {
-	// Build a clone of a packet.
+	// Same order as libobs stores the planes in.
+	switch (layout) {
+	case SPEAKERS_MONO:
+		return {speaker::FC};
+	case SPEAKERS_STEREO:
+		return {speaker::FL, speaker::FR};
+	case SPEAKERS_2POINT1:
+		return {speaker::FL, speaker::FR, speaker::LFE};
+	case SPEAKERS_4POINT0:
+		return {speaker::FL, speaker::FR, speaker::FC, speaker::RC};
+	case SPEAKERS_4POINT1:
+		return {speaker::FL, speaker::FR, speaker::FC, speaker::LFE, speaker::RC};
+	case SPEAKERS_5POINT1:
+		return {speaker::FL, speaker::FR, speaker::FC, speaker::LFE, speaker::RL, speaker::RR};
+	case SPEAKERS_7POINT1:
+		return {speaker::FL, speaker::FR, speaker::FC, speaker::LFE,
+				speaker::RL, speaker::RR, speaker::SL, speaker::SR};
+	default:
+		return {};
+	}
+}
+
+static void mix_speaker(std::vector<float_t>& gains, const std::vector<speaker>& layout, speaker from, float_t gain)
+{
+	// Place the speaker directly if the layout has it.
+	for (std::size_t idx = 0; idx < layout.size(); idx++) {
+		if (layout[idx] == from) {
+			gains[idx] += gain;
+			return;
+		}
+	}
+
+	// Otherwise use the first replacement the layout fully has, or spread it over the last one.
+	typedef std::vector<std::pair<speaker, float_t>> replacement_t;
+	std::vector<replacement_t> replacements;
+	switch (from) {
+	case speaker::FL:
+		replacements = {{{speaker::FC, AUDIO_MIX_HALF_POWER}}};
+		break;
+	case speaker::FR:
+		replacements = {{{speaker::FC, AUDIO_MIX_HALF_POWER}}};
+		break;
+	case speaker::FC:
+		replacements = {{{speaker::FL, AUDIO_MIX_HALF_POWER}, {speaker::FR, AUDIO_MIX_HALF_POWER}}};
+		break;
+	case speaker::RL:
+		replacements = {{{speaker::RC, AUDIO_MIX_HALF_POWER}},
+						{{speaker::SL, 1.f}},
+						{{speaker::FL, AUDIO_MIX_HALF_POWER}}};
+		break;
+	case speaker::RR:
+		replacements = {{{speaker::RC, AUDIO_MIX_HALF_POWER}},
+						{{speaker::SR, 1.f}},
+						{{speaker::FR, AUDIO_MIX_HALF_POWER}}};
+		break;
+	case speaker::RC:
+		replacements = {{{speaker::RL, AUDIO_MIX_HALF_POWER}, {speaker::RR, AUDIO_MIX_HALF_POWER}},
+						{{speaker::SL, AUDIO_MIX_HALF_POWER}, {speaker::SR, AUDIO_MIX_HALF_POWER}},
+						{{speaker::FL, .5f}, {speaker::FR, .5f}}};
+		break;
+	case speaker::SL:
+		replacements = {{{speaker::RL, 1.f}}, {{speaker::FL, AUDIO_MIX_HALF_POWER}}};
+		break;
+	case speaker::SR:
+		replacements = {{{speaker::RR, 1.f}}, {{speaker::FR, AUDIO_MIX_HALF_POWER}}};
+		break;
+	default: // LFE is dropped when there is nowhere to put it.
+		return;
+	}
+
+	for (std::size_t idx = 0; idx < replacements.size(); idx++) {
+		bool complete = std::all_of(replacements[idx].begin(), replacements[idx].end(), [&layout](auto& v) {
+			return std::find(layout.begin(), layout.end(), v.first) != layout.end();
+		});
+		if (complete || ((idx + 1) == replacements.size())) {
+			for (auto& v : replacements[idx]) {
+				mix_speaker(gains, layout, v.first, gain * v.second);
+			}
+			return;
+		}
+	}
+}
+
+std::map<obs_source_t*, std::weak_ptr<mirror_audio_tap>> mirror_audio_tap::_taps;
+std::mutex                                               mirror_audio_tap::_taps_lock;
+
+mirror_audio_tap::mirror_audio_tap(std::shared_ptr<obs_source_t> source)
+	: _source(source), _blocks(), _plane_size(0), _channels(0), _write(0)
+{
+	// Allocate all audio storage up front, so that the audio thread never has to.
 	audio_t*                 oad = obs_get_audio();
 	const audio_output_info* aoi = audio_output_get_info(oad);
-	osa.frames                   = audio->frames;
-	osa.timestamp                = audio->timestamp;
-	osa.speakers                 = layout;
-	osa.format                   = aoi->format;
-	osa.samples_per_sec          = aoi->samples_per_sec;
-	data.resize(MAX_AV_PLANES);
+
+	_channels   = std::min<uint32_t>(static_cast<uint32_t>(audio_output_get_channels(oad)), MAX_AV_PLANES);
+	_plane_size = AUDIO_OUTPUT_FRAMES * get_audio_bytes_per_channel(aoi->format);
+	_blocks.resize(AUDIO_BLOCKS);
+	for (auto& block : _blocks) {
+		block.data.resize(_plane_size * _channels);
+		block.osa                 = {};
+		block.osa.format          = aoi->format;
+		block.osa.samples_per_sec = aoi->samples_per_sec;
+	}
+
+	obs_source_add_audio_capture_callback(_source.get(), &mirror_audio_tap::on_audio, this);
+}
+
+mirror_audio_tap::~mirror_audio_tap()
+{
+	obs_source_remove_audio_capture_callback(_source.get(), &mirror_audio_tap::on_audio, this);
+}
+
+void mirror_audio_tap::on_audio(void* ptr, obs_source_t*, const audio_data* audio, bool) noexcept
+{
+	// Runs on the audio thread: copy into the next preallocated block and publish it, nothing else. Readers keep
+	// their own position, so a slow reader never holds up the others.
+	auto self = reinterpret_cast<mirror_audio_tap*>(ptr);
+
+	// Detect Audio Layout from underlying audio.
+	speaker_layout             detected_layout;
+	std::bitset<MAX_AV_PLANES> layout_detection;
 	for (std::size_t idx = 0; idx < MAX_AV_PLANES; idx++) {
-		if (!audio->data[idx]) {
-			osa.data[idx] = nullptr;
-			continue;
+		layout_detection.set(idx, audio->data[idx] != nullptr);
+	}
+	switch (layout_detection.to_ulong()) {
+	case 0b00000001:
+		detected_layout = SPEAKERS_MONO;
+		break;
+	case 0b00000011:
+		detected_layout = SPEAKERS_STEREO;
+		break;
+	case 0b00000111:
+		detected_layout = SPEAKERS_2POINT1;
+		break;
+	case 0b00001111:
+		detected_layout = SPEAKERS_4POINT0;
+		break;
+	case 0b00011111:
+		detected_layout = SPEAKERS_4POINT1;
+		break;
+	case 0b00111111:
+		detected_layout = SPEAKERS_5POINT1;
+		break;
+	case 0b11111111:
+		detected_layout = SPEAKERS_7POINT1;
+		break;
+	default:
+		detected_layout = SPEAKERS_UNKNOWN;
+		break;
+	}
+
+	// Packets larger than a block are split over several blocks.
+	std::size_t bytes_per_frame = self->_plane_size / AUDIO_OUTPUT_FRAMES;
+	for (uint32_t offset = 0; offset < audio->frames;) {
+		uint64_t write  = self->_write.load(std::memory_order_relaxed);
+		auto&    block  = self->_blocks[write % self->_blocks.size()];
+		uint32_t frames = std::min<uint32_t>(audio->frames - offset, AUDIO_OUTPUT_FRAMES);
+
+		uint64_t offset_ns  = (static_cast<uint64_t>(offset) * 1000000000ull) / block.osa.samples_per_sec;
+		block.osa.frames    = frames;
+		block.osa.speakers  = detected_layout;
+		block.osa.timestamp = audio->timestamp + offset_ns;
+		for (std::size_t idx = 0; idx < MAX_AV_PLANES; idx++) {
+			if ((idx >= self->_channels) || !audio->data[idx]) {
+				block.osa.data[idx] = nullptr;
+				continue;
+			}
+
+			uint8_t* plane = block.data.data() + self->_plane_size * idx;
+			memcpy(plane, audio->data[idx] + bytes_per_frame * offset, bytes_per_frame * frames);
+			block.osa.data[idx] = plane;
 		}
 
-		data[idx].resize(audio->frames * get_audio_bytes_per_channel(osa.format));
-		memcpy(data[idx].data(), audio->data[idx], data[idx].size());
-		osa.data[idx] = data[idx].data();
+		self->_write.store(write + 1, std::memory_order_release);
+		offset += frames;
 	}
 }
 
+uint64_t mirror_audio_tap::get_position()
+{
+	return _write.load(std::memory_order_acquire);
+}
+
+std::size_t mirror_audio_tap::get_safe_distance()
+{
+	// The writer never waits for readers, so keep half the ring between them as a guard.
+	return _blocks.size() / 2;
+}
+
+const mirror_audio_block& mirror_audio_tap::get_block(uint64_t index)
+{
+	return _blocks[index % _blocks.size()];
+}
+
+bool mirror_audio_tap::is_intact(uint64_t index)
+{
+	// The writer only reaches the slot of 'index' again once it is a full ring ahead. Order the preceding copy before
+	// looking at its position, so a copy that overlapped with the writer is always detected.
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return (_write.load(std::memory_order_acquire) - index) < _blocks.size();
+}
+
+std::shared_ptr<mirror_audio_tap> mirror_audio_tap::get(std::shared_ptr<obs_source_t> source)
+{
+	std::unique_lock<std::mutex> lock(_taps_lock);
+
+	if (auto kv = _taps.find(source.get()); kv != _taps.end()) {
+		if (auto tap = kv->second.lock(); tap) {
+			return tap;
+		}
+	}
+
+	// Drop taps that nobody listens to anymore.
+	for (auto kv = _taps.begin(); kv != _taps.end();) {
+		if (kv->second.expired()) {
+			kv = _taps.erase(kv);
+		} else {
+			++kv;
+		}
+	}
+
+	auto tap            = std::make_shared<mirror_audio_tap>(source);
+	_taps[source.get()] = tap;
+	return tap;
+}
+
 mirror_instance::mirror_instance(obs_data_t* settings, obs_source_t* self)
-	: obs::source_instance(settings, self), _source(), _source_child(), _signal_rename(), _audio_enabled(false),
-	  _audio_layout(SPEAKERS_UNKNOWN)
+	: obs::source_instance(settings, self), _source(), _source_child(), _signal_rename(), _cache(false),
+	  _cache_texture(), _crop_left(0), _crop_top(0), _crop_right(0), _crop_bottom(0), _scale(1.f),
+	  _audio_enabled(false), _audio_only(false), _audio_layout(SPEAKERS_UNKNOWN), _audio_tap(), _audio_read(0),
+	  _audio_copy(), _audio_mix(SPEAKERS_UNKNOWN), _audio_mix_from(SPEAKERS_UNKNOWN), _audio_mix_matrix(),
+	  _audio_mix_buffer()
 {
+	_audio_mix_matrix.resize(MAX_AV_PLANES * MAX_AV_PLANES, 0);
+	_audio_mix_buffer.resize(MAX_AV_PLANES * AUDIO_OUTPUT_FRAMES, 0);
+
 	update(settings);
 }
 
@@ -85,11 +315,19 @@ mirror_instance::~mirror_instance()
 
 uint32_t mirror_instance::get_width()
 {
+	if (_audio_only)
+		return 0;
+	if (_cache_texture)
+		return std::max<uint32_t>(static_cast<uint32_t>(get_crop_size().first * _scale), 1);
 	return _source_size.first ? _source_size.first : 1;
 }
 
 uint32_t mirror_instance::get_height()
 {
+	if (_audio_only)
+		return 0;
+	if (_cache_texture)
+		return std::max<uint32_t>(static_cast<uint32_t>(get_crop_size().second * _scale), 1);
 	return _source_size.second ? _source_size.second : 1;
 }
 
@@ -113,7 +351,18 @@ void mirror_instance::update(obs_data_t* data)
 {
 	// Audio
 	_audio_enabled = obs_data_get_bool(data, ST_SOURCE_AUDIO);
+	_audio_only    = _audio_enabled && obs_data_get_bool(data, ST_SOURCE_AUDIO_ONLY);
 	_audio_layout  = static_cast<speaker_layout>(obs_data_get_int(data, ST_SOURCE_AUDIO_LAYOUT));
+	_audio_mix     = static_cast<speaker_layout>(obs_data_get_int(data, ST_SOURCE_AUDIO_MIX));
+	_audio_mix_from = SPEAKERS_UNKNOWN;
+
+	// Cache
+	_cache       = obs_data_get_bool(data, ST_CACHE);
+	_scale       = static_cast<float_t>(obs_data_get_double(data, ST_CACHE_SCALE) / 100.0);
+	_crop_left   = static_cast<uint32_t>(obs_data_get_int(data, ST_CACHE_CROP_LEFT));
+	_crop_top    = static_cast<uint32_t>(obs_data_get_int(data, ST_CACHE_CROP_TOP));
+	_crop_right  = static_cast<uint32_t>(obs_data_get_int(data, ST_CACHE_CROP_RIGHT));
+	_crop_bottom = static_cast<uint32_t>(obs_data_get_int(data, ST_CACHE_CROP_BOTTOM));
 
 	// Acquire new source.
 	acquire(obs_data_get_string(data, ST_SOURCE));
@@ -128,11 +377,14 @@ void mirror_instance::save(obs_data_t* data)
 	}
 }
 
-void mirror_instance::video_tick(float_t time) {}
+void mirror_instance::video_tick(float_t time)
+{
+	audio_output();
+}
 
 void mirror_instance::video_render(gs_effect_t* effect)
 {
-	if (!_source)
+	if (!_source || _audio_only)
 		return;
 	if ((obs_source_get_output_flags(_source.get()) & OBS_SOURCE_VIDEO) == 0)
 		return;
@@ -145,12 +397,33 @@ void mirror_instance::video_render(gs_effect_t* effect)
 	_source_size.first  = obs_source_get_width(_source.get());
 	_source_size.second = obs_source_get_height(_source.get());
 
-	obs_source_video_render(_source.get());
+	if (!_cache_texture) {
+		obs_source_video_render(_source.get());
+		return;
+	}
+
+	// Sample the shared frame, cropping and scaling it in the same draw.
+	auto crop = get_crop_size();
+	if ((_source_size.first == 0) || (_source_size.second == 0) || (crop.first == 0) || (crop.second == 0))
+		return;
+
+	std::shared_ptr<gs::texture> tex = _cache_texture->render(_source_size.first, _source_size.second);
+	if (!tex)
+		return;
+
+	gs_effect_t* default_effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+	gs_effect_set_texture(gs_effect_get_param_by_name(default_effect, "image"), tex->get_object());
+	gs_matrix_push();
+	gs_matrix_scale3f(_scale, _scale, 1.f);
+	while (gs_effect_loop(default_effect, "Draw")) {
+		gs_draw_sprite_subregion(tex->get_object(), 0, _crop_left, _crop_top, crop.first, crop.second);
+	}
+	gs_matrix_pop();
 }
 
 void mirror_instance::enum_active_sources(obs_source_enum_proc_t cb, void* ptr)
 {
-	if (!_source)
+	if (!_source || _audio_only)
 		return;
 	cb(_self, _source.get(), ptr);
 }
@@ -175,10 +448,19 @@ try {
 	}
 
 	// Everything went well, store.
-	_source_child       = std::make_shared<obs::tools::child_source>(_self, source);
-	_source             = source;
-	_source_size.first  = obs_source_get_width(_source.get());
-	_source_size.second = obs_source_get_height(_source.get());
+	_source = source;
+	if (!_audio_only) {
+		// Audio only mirrors never show the source, so they don't keep it active either.
+		if (_cache) {
+			_cache_texture = std::make_shared<gfx::source_texture>(_source.get(), _self);
+		} else {
+			_source_child = std::make_shared<obs::tools::child_source>(_self, source);
+		}
+		_source_size.first  = obs_source_get_width(_source.get());
+		_source_size.second = obs_source_get_height(_source.get());
+	} else {
+		_source_size = {0, 0};
+	}
 
 	// Listen to the rename event to update our own settings.
 	_signal_rename = std::make_shared<obs::source_signal_handler>("rename", _source);
@@ -187,9 +469,8 @@ try {
 
 	// Listen to any audio the source spews out.
 	if (_audio_enabled) {
-		_signal_audio = std::make_shared<obs::audio_signal_handler>(_source);
-		_signal_audio->event.add(std::bind(&mirror_instance::on_audio, this, std::placeholders::_1,
-										   std::placeholders::_2, std::placeholders::_3));
+		_audio_tap  = mirror_audio_tap::get(_source);
+		_audio_read = _audio_tap->get_position();
 	}
 } catch (...) {
 	release();
@@ -197,77 +478,120 @@ try {
 
 void mirror_instance::release()
 {
-	_signal_audio.reset();
+	_audio_tap.reset();
 	_signal_rename.reset();
+	_cache_texture.reset();
 	_source_child.reset();
 	_source.reset();
 }
 
+std::pair<uint32_t, uint32_t> mirror_instance::get_crop_size()
+{
+	uint32_t width  = _source_size.first;
+	uint32_t height = _source_size.second;
+	return {(_crop_left + _crop_right) < width ? width - _crop_left - _crop_right : 0,
+			(_crop_top + _crop_bottom) < height ? height - _crop_top - _crop_bottom : 0};
+}
+
 void mirror_instance::on_rename(std::shared_ptr<obs_source_t>, calldata*)
 {
 	obs_source_save(_self);
 }
 
-void mirror_instance::on_audio(std::shared_ptr<obs_source_t>, const audio_data* audio, bool)
+void mirror_instance::audio_output()
 {
-	// Immediately quit if there isn't any actual audio to send out.
-	if (!_audio_enabled) {
+	if (!_audio_tap)
 		return;
+
+	// Skip ahead if we fell too far behind, as the tap may already be overwriting those blocks.
+	uint64_t write    = _audio_tap->get_position();
+	uint64_t distance = write - _audio_read;
+	if (distance > _audio_tap->get_safe_distance()) {
+		DLOG_WARNING("<source-mirror> Instance '%s' dropped %" PRIu64 " audio packets.", obs_source_get_name(_self),
+					 distance - _audio_tap->get_safe_distance());
+		_audio_read = write - _audio_tap->get_safe_distance();
 	}
 
-	// Detect Audio Layout from underlying audio.
-	speaker_layout detected_layout;
-	if (_audio_layout != SPEAKERS_UNKNOWN) {
-		detected_layout = _audio_layout;
-	} else {
-		std::bitset<MAX_AV_PLANES> layout_detection;
+	// Output everything that arrived since the last tick in one go, only overriding the layout if asked to.
+	for (; _audio_read != write; _audio_read++) {
+		// Copy the block first and only use it if the writer didn't get to it in the meantime.
+		const mirror_audio_block& block = _audio_tap->get_block(_audio_read);
+		obs_source_audio          osa   = block.osa;
+		_audio_copy.resize(block.data.size());
+		memcpy(_audio_copy.data(), block.data.data(), block.data.size());
 		for (std::size_t idx = 0; idx < MAX_AV_PLANES; idx++) {
-			layout_detection.set(idx, audio->data[idx] != nullptr);
+			if (osa.data[idx]) {
+				osa.data[idx] = _audio_copy.data() + (osa.data[idx] - block.data.data());
+			}
 		}
-		switch (layout_detection.to_ulong()) {
-		case 0b00000001:
-			detected_layout = SPEAKERS_MONO;
-			break;
-		case 0b00000011:
-			detected_layout = SPEAKERS_STEREO;
-			break;
-		case 0b00000111:
-			detected_layout = SPEAKERS_2POINT1;
-			break;
-		case 0b00001111:
-			detected_layout = SPEAKERS_4POINT0;
-			break;
-		case 0b00011111:
-			detected_layout = SPEAKERS_4POINT1;
-			break;
-		case 0b00111111:
-			detected_layout = SPEAKERS_5POINT1;
-			break;
-		case 0b11111111:
-			detected_layout = SPEAKERS_7POINT1;
-			break;
-		default:
-			detected_layout = SPEAKERS_UNKNOWN;
-			break;
+		if (!_audio_tap->is_intact(_audio_read)) {
+			uint64_t position = _audio_tap->get_position();
+			DLOG_WARNING("<source-mirror> Instance '%s' dropped %" PRIu64 " audio packets.", obs_source_get_name(_self),
+						 position - _audio_read - _audio_tap->get_safe_distance());
+			_audio_read = position - _audio_tap->get_safe_distance() - 1;
+			write       = position;
+			continue;
 		}
-	}
 
-	{
-		std::unique_lock<std::mutex> ul(_audio_queue_lock);
-		_audio_queue.emplace(audio, detected_layout);
+		if (_audio_layout != SPEAKERS_UNKNOWN) {
+			osa.speakers = _audio_layout;
+		}
+		if ((_audio_mix != SPEAKERS_UNKNOWN) && (_audio_mix != osa.speakers)) {
+			if (!audio_mix(osa))
+				continue;
+		}
+		obs_source_output_audio(_self, &osa);
 	}
-
-	// Create a clone of the audio data and push it to the thread pool.
-	streamfx::threadpool()->push(std::bind(&mirror_instance::audio_output, this, std::placeholders::_1), nullptr);
 }
 
-void mirror_instance::audio_output(std::shared_ptr<void> data)
+bool mirror_instance::audio_mix(obs_source_audio& osa)
 {
-	std::unique_lock<std::mutex> ul(_audio_queue_lock);
-	while (_audio_queue.size() > 0) {
-		obs_source_output_audio(_self, &((_audio_queue.front()).osa));
-		_audio_queue.pop();
+	// libobs hands captured audio out as planar float, anything else can't be mixed here.
+	if ((osa.format != AUDIO_FORMAT_FLOAT_PLANAR) || (osa.speakers == SPEAKERS_UNKNOWN)
+		|| (osa.frames > AUDIO_OUTPUT_FRAMES)) {
+		return false;
 	}
+
+	auto ins  = get_speakers(osa.speakers);
+	auto outs = get_speakers(_audio_mix);
+
+	// Rebuild the matrix only when the source layout changes.
+	if (_audio_mix_from != osa.speakers) {
+		std::fill(_audio_mix_matrix.begin(), _audio_mix_matrix.end(), 0.f);
+		std::vector<float_t> gains(outs.size());
+		for (std::size_t in = 0; in < ins.size(); in++) {
+			std::fill(gains.begin(), gains.end(), 0.f);
+			mix_speaker(gains, outs, ins[in], 1.f);
+			for (std::size_t out = 0; out < outs.size(); out++) {
+				_audio_mix_matrix[out * MAX_AV_PLANES + in] = gains[out];
+			}
+		}
+		_audio_mix_from = osa.speakers;
+	}
+
+	// Plane by plane multiply-accumulate, which compilers turn into vector code.
+	for (std::size_t out = 0; out < outs.size(); out++) {
+		float_t* dst = _audio_mix_buffer.data() + out * AUDIO_OUTPUT_FRAMES;
+		std::fill(dst, dst + osa.frames, 0.f);
+		for (std::size_t in = 0; in < ins.size(); in++) {
+			float_t gain = _audio_mix_matrix[out * MAX_AV_PLANES + in];
+			if ((gain == 0.f) || !osa.data[in])
+				continue;
+
+			const float_t* src = reinterpret_cast<const float_t*>(osa.data[in]);
+			for (uint32_t idx = 0; idx < osa.frames; idx++) {
+				dst[idx] += src[idx] * gain;
+			}
+		}
+	}
+
+	for (std::size_t idx = 0; idx < MAX_AV_PLANES; idx++) {
+		osa.data[idx] = (idx < outs.size())
+							? reinterpret_cast<const uint8_t*>(_audio_mix_buffer.data() + idx * AUDIO_OUTPUT_FRAMES)
+							: nullptr;
+	}
+	osa.speakers = _audio_mix;
+	return true;
 }
 
 mirror_factory::mirror_factory()
@@ -294,6 +618,14 @@ void mirror_factory::get_defaults2(obs_data_t* data)
 	obs_data_set_default_string(data, ST_SOURCE, "");
 	obs_data_set_default_bool(data, ST_SOURCE_AUDIO, false);
 	obs_data_set_default_int(data, ST_SOURCE_AUDIO_LAYOUT, static_cast<int64_t>(SPEAKERS_UNKNOWN));
+	obs_data_set_default_bool(data, ST_SOURCE_AUDIO_ONLY, false);
+	obs_data_set_default_int(data, ST_SOURCE_AUDIO_MIX, static_cast<int64_t>(SPEAKERS_UNKNOWN));
+	obs_data_set_default_bool(data, ST_CACHE, false);
+	obs_data_set_default_double(data, ST_CACHE_SCALE, 100.0);
+	obs_data_set_default_int(data, ST_CACHE_CROP_LEFT, 0);
+	obs_data_set_default_int(data, ST_CACHE_CROP_TOP, 0);
+	obs_data_set_default_int(data, ST_CACHE_CROP_RIGHT, 0);
+	obs_data_set_default_int(data, ST_CACHE_CROP_BOTTOM, 0);
 }
 
 static bool modified_properties(obs_properties_t* pr, obs_property_t* p, obs_data_t* data) noexcept
@@ -301,6 +633,17 @@ try {
 	if (obs_properties_get(pr, ST_SOURCE_AUDIO) == p) {
 		bool show = obs_data_get_bool(data, ST_SOURCE_AUDIO);
 		obs_property_set_visible(obs_properties_get(pr, ST_SOURCE_AUDIO_LAYOUT), show);
+		obs_property_set_visible(obs_properties_get(pr, ST_SOURCE_AUDIO_ONLY), show);
+		obs_property_set_visible(obs_properties_get(pr, ST_SOURCE_AUDIO_MIX), show);
+		return true;
+	}
+	if (obs_properties_get(pr, ST_CACHE) == p) {
+		bool show = obs_data_get_bool(data, ST_CACHE);
+		obs_property_set_visible(obs_properties_get(pr, ST_CACHE_SCALE), show);
+		obs_property_set_visible(obs_properties_get(pr, ST_CACHE_CROP_LEFT), show);
+		obs_property_set_visible(obs_properties_get(pr, ST_CACHE_CROP_TOP), show);
+		obs_property_set_visible(obs_properties_get(pr, ST_CACHE_CROP_RIGHT), show);
+		obs_property_set_visible(obs_properties_get(pr, ST_CACHE_CROP_BOTTOM), show);
 		return true;
 	}
 	return false;
@@ -327,7 +670,7 @@ obs_properties_t* mirror_factory::get_properties2(mirror_instance* data)
 				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
 				return false;
 			},
-			obs::source_tracker::filter_sources);
+			obs::source_tracker::index::Sources);
 		obs::source_tracker::get()->enumerate(
 			[&p](std::string name, obs_source_t*) {
 				std::stringstream sstr;
@@ -335,7 +678,26 @@ obs_properties_t* mirror_factory::get_properties2(mirror_instance* data)
 				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
 				return false;
 			},
-			obs::source_tracker::filter_scenes);
+			obs::source_tracker::index::Scenes);
+	}
+
+	{
+		p = obs_properties_add_bool(pr, ST_CACHE, D_TRANSLATE(ST_CACHE));
+		obs_property_set_long_description(p, D_TRANSLATE(D_DESC(ST_CACHE)));
+		obs_property_set_modified_callback(p, modified_properties);
+
+		p = obs_properties_add_float_slider(pr, ST_CACHE_SCALE, D_TRANSLATE(ST_CACHE_SCALE), 1.0, 100.0, 0.01);
+		obs_property_set_long_description(p, D_TRANSLATE(D_DESC(ST_CACHE_SCALE)));
+		obs_property_float_set_suffix(p, " %");
+
+		p = obs_properties_add_int(pr, ST_CACHE_CROP_LEFT, D_TRANSLATE(ST_CACHE_CROP_LEFT), 0, 16384, 1);
+		obs_property_int_set_suffix(p, " px");
+		p = obs_properties_add_int(pr, ST_CACHE_CROP_TOP, D_TRANSLATE(ST_CACHE_CROP_TOP), 0, 16384, 1);
+		obs_property_int_set_suffix(p, " px");
+		p = obs_properties_add_int(pr, ST_CACHE_CROP_RIGHT, D_TRANSLATE(ST_CACHE_CROP_RIGHT), 0, 16384, 1);
+		obs_property_int_set_suffix(p, " px");
+		p = obs_properties_add_int(pr, ST_CACHE_CROP_BOTTOM, D_TRANSLATE(ST_CACHE_CROP_BOTTOM), 0, 16384, 1);
+		obs_property_int_set_suffix(p, " px");
 	}
 
 	{
@@ -365,6 +727,31 @@ obs_properties_t* mirror_factory::get_properties2(mirror_instance* data)
 		obs_property_set_long_description(p, D_TRANSLATE(D_DESC(ST_SOURCE_AUDIO_LAYOUT)));
 	}
 
+	{
+		p = obs_properties_add_list(pr, ST_SOURCE_AUDIO_MIX, D_TRANSLATE(ST_SOURCE_AUDIO_MIX), OBS_COMBO_TYPE_LIST,
+									OBS_COMBO_FORMAT_INT);
+		obs_property_list_add_int(p, D_TRANSLATE(ST_SOURCE_AUDIO_MIX_NONE), static_cast<int64_t>(SPEAKERS_UNKNOWN));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_SOURCE_AUDIO_LAYOUT_(Mono)), static_cast<int64_t>(SPEAKERS_MONO));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_SOURCE_AUDIO_LAYOUT_(Stereo)),
+								  static_cast<int64_t>(SPEAKERS_STEREO));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_SOURCE_AUDIO_LAYOUT_(StereoLFE)),
+								  static_cast<int64_t>(SPEAKERS_2POINT1));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_SOURCE_AUDIO_LAYOUT_(Quadraphonic)),
+								  static_cast<int64_t>(SPEAKERS_4POINT0));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_SOURCE_AUDIO_LAYOUT_(QuadraphonicLFE)),
+								  static_cast<int64_t>(SPEAKERS_4POINT1));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_SOURCE_AUDIO_LAYOUT_(Surround)),
+								  static_cast<int64_t>(SPEAKERS_5POINT1));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_SOURCE_AUDIO_LAYOUT_(FullSurround)),
+								  static_cast<int64_t>(SPEAKERS_7POINT1));
+		obs_property_set_long_description(p, D_TRANSLATE(D_DESC(ST_SOURCE_AUDIO_MIX)));
+	}
+
+	{
+		p = obs_properties_add_bool(pr, ST_SOURCE_AUDIO_ONLY, D_TRANSLATE(ST_SOURCE_AUDIO_ONLY));
+		obs_property_set_long_description(p, D_TRANSLATE(D_DESC(ST_SOURCE_AUDIO_ONLY)));
+	}
+
 	return pr;
 }
 
@@ -19,10 +19,9 @@
 
 #pragma once
 #include "common.hpp"
-#include <condition_variable>
+#include <atomic>
+#include <map>
 #include <mutex>
-#include <queue>
-#include <thread>
 #include <vector>
 #include "gfx/gfx-source-texture.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
@@ -33,11 +32,47 @@
 #include "obs/obs-tools.hpp"
 
 namespace streamfx::source::mirror {
-	struct mirror_audio_data {
-		mirror_audio_data(const audio_data*, speaker_layout);
+	// Preallocated audio packet, filled by the audio thread and output by the video tick.
+	struct mirror_audio_block {
+		obs_source_audio     osa;
+		std::vector<uint8_t> data;
+	};
+
+	/** Captures the audio of one source once, for any number of mirrors to read from. */
+	class mirror_audio_tap {
+		std::shared_ptr<obs_source_t>   _source;
+		std::vector<mirror_audio_block> _blocks;
+		std::size_t                     _plane_size;
+		uint32_t                        _channels;
+		std::atomic<uint64_t>           _write;
+
+		static void on_audio(void* ptr, obs_source_t*, const struct audio_data*, bool) noexcept;
+
+		public:
+		mirror_audio_tap(std::shared_ptr<obs_source_t> source);
+		~mirror_audio_tap();
+
+		/** Index of the next block to be written; blocks before it are complete. */
+		uint64_t get_position();
+
+		/** Number of blocks that are guaranteed not to be overwritten while being read. */
+		std::size_t get_safe_distance();
+
+		const mirror_audio_block& get_block(uint64_t index);
 
-		obs_source_audio                  osa;
-		std::vector<std::vector<uint8_t>> data;
+		/** Whether a block read after it was published can't have been touched by the writer since.
+		 *
+		 * Check this after copying a block, as the writer may start overwriting it at any time.
+		 */
+		bool is_intact(uint64_t index);
+
+		private:
+		static std::map<obs_source_t*, std::weak_ptr<mirror_audio_tap>> _taps;
+		static std::mutex                                               _taps_lock;
+
+		public:
+		/** Get the shared tap for a source, creating it if nobody listens to it yet. */
+		static std::shared_ptr<mirror_audio_tap> get(std::shared_ptr<obs_source_t> source);
 	};
 
 	class mirror_instance : public obs::source_instance {
@@ -45,14 +80,30 @@ namespace streamfx::source::mirror {
 		std::shared_ptr<obs_source_t>               _source;
 		std::shared_ptr<obs::tools::child_source>   _source_child;
 		std::shared_ptr<obs::source_signal_handler> _signal_rename;
-		std::shared_ptr<obs::audio_signal_handler>  _signal_audio;
 		std::pair<uint32_t, uint32_t>               _source_size;
 
+		// Cache, shares one render of the source per frame between all cached mirrors.
+		bool                                 _cache;
+		std::shared_ptr<gfx::source_texture> _cache_texture;
+		uint32_t                             _crop_left;
+		uint32_t                             _crop_top;
+		uint32_t                             _crop_right;
+		uint32_t                             _crop_bottom;
+		float_t                              _scale;
+
 		// Audio
-		bool                          _audio_enabled;
-		speaker_layout                _audio_layout;
-		std::mutex                    _audio_queue_lock;
-		std::queue<mirror_audio_data> _audio_queue;
+		bool                              _audio_enabled;
+		bool                              _audio_only;
+		speaker_layout                    _audio_layout;
+		std::shared_ptr<mirror_audio_tap> _audio_tap;
+		uint64_t                          _audio_read;
+		std::vector<uint8_t>              _audio_copy;
+
+		// Audio Mixing
+		speaker_layout       _audio_mix;
+		speaker_layout       _audio_mix_from;
+		std::vector<float_t> _audio_mix_matrix;
+		std::vector<float_t> _audio_mix_buffer;
 
 		public:
 		mirror_instance(obs_data_t* settings, obs_source_t* self);
@@ -76,10 +127,13 @@ namespace streamfx::source::mirror {
 		void acquire(std::string source_name);
 		void release();
 
+		std::pair<uint32_t, uint32_t> get_crop_size();
+
 		void on_rename(std::shared_ptr<obs_source_t>, calldata*);
-		void on_audio(std::shared_ptr<obs_source_t>, const struct audio_data*, bool);
 
-		void audio_output(std::shared_ptr<void> data);
+		void audio_output();
+
+		bool audio_mix(obs_source_audio& osa);
 	};
 
 	class mirror_factory : public obs::source_factory<source::mirror::mirror_factory, source::mirror::mirror_instance> {
@@ -60,14 +60,13 @@ inline void qt_cleanup_resource()
 bool streamfx::ui::handler::have_shown_about_streamfx(bool shown)
 {
 	auto config = streamfx::configuration::instance();
-	auto data   = config->get();
 	if (shown) {
-		obs_data_set_bool(data.get(), _cfg_have_shown_about.data(), true);
+		config->set_bool(_cfg_have_shown_about, true);
 	}
 	if (config->is_different_version()) {
 		return false;
 	} else {
-		return obs_data_get_bool(data.get(), _cfg_have_shown_about.data());
+		return config->get_bool(_cfg_have_shown_about);
 	}
 }
 
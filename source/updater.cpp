@@ -20,13 +20,16 @@
 
 #include "updater.hpp"
 #include "version.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <mutex>
 #include <string_view>
 #include "configuration.hpp"
 #include "plugin.hpp"
 
 // TODO:
-// - Cache result in the configuration directory (not as a configuration value).
 // - Move 'autoupdater.last_checked_at' to out of the configuration.
 // - Figure out if nightly updates are viable at all.
 
@@ -45,6 +48,11 @@
 #define ST_CFG_CHANNEL "updater.channel"
 #define ST_CFG_LASTCHECKEDAT "updater.lastcheckedat"
 
+#define ST_CACHE_FILE "updater/releases.json"
+#define ST_CACHE_META_FILE "updater/releases.meta.json"
+
+#define ST_ENV_URL "STREAMFX_UPDATER_URL"
+
 void streamfx::to_json(nlohmann::json& json, const update_info& info)
 {
 	auto version     = nlohmann::json::object();
@@ -227,21 +235,45 @@ void streamfx::updater::task_query(std::vector<char>& buffer)
 {
 	static constexpr std::string_view ST_API_URL = "https://api.github.com/repos/Xaymar/obs-StreamFX/releases";
 
-	util::curl curl;
-	size_t     buffer_offset = 0;
+	auto        curl          = std::make_shared<util::curl>();
+	size_t      buffer_offset = 0;
+	std::string etag;
+	std::string last_modified;
+
+	// Allow pointing the updater at a different server, for example a local one for testing.
+	std::string url{ST_API_URL};
+	if (const char* env_url = getenv(ST_ENV_URL); env_url && (env_url[0] != 0)) {
+		url = env_url;
+	}
 
 	// Set headers (User-Agent is needed so Github can contact us!).
-	curl.set_header("User-Agent", "StreamFX Updater v" STREAMFX_VERSION_STRING);
-	curl.set_header("Accept", "application/vnd.github.v3+json");
+	curl->set_header("User-Agent", "StreamFX Updater v" STREAMFX_VERSION_STRING);
+	curl->set_header("Accept", "application/vnd.github.v3+json");
+
+	// Only ask for the full response if it changed since we last cached it.
+	std::filesystem::path cache_path      = streamfx::config_file_path(ST_CACHE_FILE);
+	std::filesystem::path cache_meta_path = streamfx::config_file_path(ST_CACHE_META_FILE);
+	if (std::filesystem::exists(cache_path) && std::filesystem::exists(cache_meta_path)) {
+		try {
+			std::ifstream  file(cache_meta_path, std::ios::binary);
+			nlohmann::json meta = nlohmann::json::parse(file);
+			if (auto kv = meta.find("etag"); (kv != meta.end()) && kv->is_string())
+				curl->set_header("If-None-Match", kv->get<std::string>());
+			if (auto kv = meta.find("last_modified"); (kv != meta.end()) && kv->is_string())
+				curl->set_header("If-Modified-Since", kv->get<std::string>());
+		} catch (const std::exception& ex) {
+			D_LOG_DEBUG("Ignoring broken response cache: %s", ex.what());
+		}
+	}
 
 	// Set up request.
-	curl.set_option(CURLOPT_HTTPGET, true); // GET
-	curl.set_option(CURLOPT_POST, false);   // Not POST
-	curl.set_option(CURLOPT_URL, ST_API_URL);
-	curl.set_option(CURLOPT_TIMEOUT, 10); // 10s until we fail.
+	curl->set_option(CURLOPT_HTTPGET, true); // GET
+	curl->set_option(CURLOPT_POST, false);   // Not POST
+	curl->set_option(CURLOPT_URL, url);
+	curl->set_option(CURLOPT_TIMEOUT, 10); // 10s until we fail.
 
 	// Callbacks
-	curl.set_write_callback([this, &buffer, &buffer_offset](void* data, size_t s1, size_t s2) {
+	curl->set_write_callback([this, &buffer, &buffer_offset](void* data, size_t s1, size_t s2) {
 		size_t size = s1 * s2;
 		if (buffer.size() < (size + buffer_offset))
 			buffer.resize(buffer_offset + size);
@@ -251,7 +283,25 @@ void streamfx::updater::task_query(std::vector<char>& buffer)
 
 		return s1 * s2;
 	});
-	//std::bind(&streamfx::updater::task_write_cb, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)
+	curl->set_header_callback([&etag, &last_modified](void* data, size_t s1, size_t s2) {
+		std::string_view line{reinterpret_cast<const char*>(data), s1 * s2};
+		if (size_t colon = line.find(':'); colon != std::string_view::npos) {
+			std::string name{line.substr(0, colon)};
+			std::transform(name.begin(), name.end(), name.begin(),
+						   [](char c) { return static_cast<char>(tolower(c)); });
+
+			std::string_view value = line.substr(colon + 1);
+			value.remove_prefix(std::min(value.find_first_not_of(" \t"), value.size()));
+			value.remove_suffix(value.size() - std::min(value.find_last_not_of(" \t\r\n") + 1, value.size()));
+
+			if (name == "etag") {
+				etag = value;
+			} else if (name == "last-modified") {
+				last_modified = value;
+			}
+		}
+		return s1 * s2;
+	});
 
 	// Clear any unknown data and reserve 64KiB of memory.
 	buffer.clear();
@@ -259,53 +309,217 @@ void streamfx::updater::task_query(std::vector<char>& buffer)
 
 	// Finally, execute the request.
 	D_LOG_DEBUG("Querying for latest releases...");
-	if (CURLcode res = curl.perform(); res != CURLE_OK) {
+	// Prefer the shared client, which keeps connections and TLS sessions alive between checks.
+	CURLcode res = CURLE_OK;
+	if (auto client = util::curl_client::get(); client) {
+		res = client->perform(curl).get();
+	} else {
+		res = curl->perform();
+	}
+	if (res != CURLE_OK) {
 		D_LOG_ERROR("Performing query failed with error: %s", curl_easy_strerror(res));
 		throw std::runtime_error(curl_easy_strerror(res));
 	}
 
 	int32_t status_code = 0;
-	if (CURLcode res = curl.get_info(CURLINFO_HTTP_CODE, status_code); res != CURLE_OK) {
+	if (CURLcode res = curl->get_info(CURLINFO_HTTP_CODE, status_code); res != CURLE_OK) {
 		D_LOG_ERROR("Retrieving status code failed with error: %s", curl_easy_strerror(res));
 		throw std::runtime_error(curl_easy_strerror(res));
 	}
 	D_LOG_DEBUG("API returned status code %d.", status_code);
 
-	if (status_code != 200) {
+	if (status_code == 304) {
+		// Nothing changed, use what we have.
+		D_LOG_DEBUG("Releases did not change, using cached response.");
+		std::ifstream file(cache_path, std::ios::binary | std::ios::ate);
+		if (!file) {
+			throw std::runtime_error("Response cache vanished.");
+		}
+		buffer.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		return;
+	} else if (status_code != 200) {
 		D_LOG_ERROR("API returned unexpected status code %d.", status_code);
 		throw std::runtime_error("Request failed due to one or more reasons.");
 	}
+	buffer.resize(buffer_offset);
+
+	// Remember the response for the next conditional request. Failing to do so only costs a full download next time.
+	try {
+		std::filesystem::create_directories(cache_path.parent_path());
+		{
+			std::ofstream file(cache_path, std::ios::binary | std::ios::trunc);
+			file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		}
+		{
+			nlohmann::json meta = nlohmann::json::object();
+			if (!etag.empty())
+				meta["etag"] = etag;
+			if (!last_modified.empty())
+				meta["last_modified"] = last_modified;
+			std::ofstream file(cache_meta_path, std::ios::binary | std::ios::trunc);
+			file << meta.dump();
+		}
+	} catch (const std::exception& ex) {
+		D_LOG_WARNING("Failed to cache response: %s", ex.what());
+	}
 }
 
+namespace streamfx {
+	/** Streams through the GitHub release list, only keeping the few fields we need from each release.
+	 *
+	 * Every release is looked at, as GitHub sorts them by creation date: a hotfix for an older version may be listed
+	 * before a newer release.
+	 */
+	class updater_release_sax {
+		std::function<void(nlohmann::json&)> _on_release;
+		std::size_t                          _depth;
+		std::string                          _key;
+		nlohmann::json                       _entry;
+		bool                                 _is_array;
+
+		bool is_wanted()
+		{
+			// Skip everything else, especially the potentially large release notes.
+			return (_key == "tag_name") || (_key == "name") || (_key == "html_url") || (_key == "prerelease");
+		}
+
+		public:
+		std::string error;
+
+		updater_release_sax(std::function<void(nlohmann::json&)> on_release)
+			: _on_release(on_release), _depth(0), _key(), _entry(), _is_array(false), error()
+		{}
+
+		/** Whether the document was an array, which also rejects a response that is a single value. */
+		bool is_array()
+		{
+			return _is_array;
+		}
+
+		bool null()
+		{
+			return true;
+		}
+
+		bool boolean(bool value)
+		{
+			if ((_depth == 2) && is_wanted())
+				_entry[_key] = value;
+			return true;
+		}
+
+		bool number_integer(nlohmann::json::number_integer_t)
+		{
+			return true;
+		}
+
+		bool number_unsigned(nlohmann::json::number_unsigned_t)
+		{
+			return true;
+		}
+
+		bool number_float(nlohmann::json::number_float_t, const nlohmann::json::string_t&)
+		{
+			return true;
+		}
+
+		bool string(nlohmann::json::string_t& value)
+		{
+			if ((_depth == 2) && is_wanted())
+				_entry[_key] = value;
+			return true;
+		}
+
+		bool binary(nlohmann::json::binary_t&)
+		{
+			return true;
+		}
+
+		bool start_object(std::size_t)
+		{
+			if (_depth == 0) {
+				error = "Response is not a JSON array.";
+				return false;
+			}
+			if (++_depth == 2)
+				_entry = nlohmann::json::object();
+			return true;
+		}
+
+		bool key(nlohmann::json::string_t& value)
+		{
+			if (_depth == 2)
+				_key = value;
+			return true;
+		}
+
+		bool end_object()
+		{
+			if (_depth-- == 2)
+				_on_release(_entry);
+			return true;
+		}
+
+		bool start_array(std::size_t)
+		{
+			if (_depth == 0)
+				_is_array = true;
+			_depth++;
+			return true;
+		}
+
+		bool end_array()
+		{
+			_depth--;
+			return true;
+		}
+
+		bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex)
+		{
+			error = ex.what();
+			return false;
+		}
+	};
+} // namespace streamfx
+
 void streamfx::updater::task_parse(std::vector<char>& buffer)
 {
-	// Parse the JSON response from the API.
-	nlohmann::json json = nlohmann::json::parse(buffer.begin(), buffer.end());
+	update_info release_info;
+	update_info testing_info;
 
-	// Check if it was parsed as an object.
-	if (json.type() != nlohmann::json::value_t::array) {
-		throw std::runtime_error("Response is not a JSON array.");
-	}
-
-	// Iterate over all entries.
-	std::lock_guard<std::mutex> lock(_lock);
-	for (auto obj : json) {
+	// Parse the JSON response from the API, skipping everything we don't need.
+	updater_release_sax sax{[&release_info, &testing_info](nlohmann::json& obj) {
 		try {
 			auto info = obj.get<streamfx::update_info>();
 
 			if (info.channel == update_channel::RELEASE) {
-				if (_release_info.is_newer(info))
-					_release_info = info;
-				if (_testing_info.is_newer(info))
-					_testing_info = info;
+				if (release_info.is_newer(info))
+					release_info = info;
+				if (testing_info.is_newer(info))
+					testing_info = info;
 			} else {
-				if (_testing_info.is_newer(info))
-					_testing_info = info;
+				if (testing_info.is_newer(info))
+					testing_info = info;
 			}
 		} catch (const std::exception& ex) {
 			D_LOG_DEBUG("Failed to parse entry, error: %s", ex.what());
 		}
+	}};
+	nlohmann::json::sax_parse(buffer.begin(), buffer.end(), &sax);
+	if (!sax.error.empty()) {
+		throw std::runtime_error(sax.error);
+	}
+	if (!sax.is_array()) {
+		throw std::runtime_error("Response is not a JSON array.");
 	}
+
+	std::lock_guard<std::mutex> lock(_lock);
+	if (_release_info.is_newer(release_info))
+		_release_info = release_info;
+	if (_testing_info.is_newer(testing_info))
+		_testing_info = testing_info;
 }
 
 bool streamfx::updater::can_check()
@@ -323,28 +537,22 @@ void streamfx::updater::load()
 {
 	std::lock_guard<std::mutex> lock(_lock);
 	if (auto config = streamfx::configuration::instance(); config) {
-		auto dataptr = config->get();
-
-		if (obs_data_has_user_value(dataptr.get(), ST_CFG_GDPR))
-			_gdpr = obs_data_get_bool(dataptr.get(), ST_CFG_GDPR);
-		if (obs_data_has_user_value(dataptr.get(), ST_CFG_AUTOMATION))
-			_automation = obs_data_get_bool(dataptr.get(), ST_CFG_AUTOMATION);
-		if (obs_data_has_user_value(dataptr.get(), ST_CFG_CHANNEL))
-			_channel = static_cast<update_channel>(obs_data_get_int(dataptr.get(), ST_CFG_CHANNEL));
-		if (obs_data_has_user_value(dataptr.get(), ST_CFG_LASTCHECKEDAT))
-			_lastcheckedat = std::chrono::seconds(obs_data_get_int(dataptr.get(), ST_CFG_LASTCHECKEDAT));
+		_gdpr       = config->get_bool(ST_CFG_GDPR, _gdpr);
+		_automation = config->get_bool(ST_CFG_AUTOMATION, _automation);
+		_channel    = static_cast<update_channel>(config->get_integer(ST_CFG_CHANNEL, static_cast<int64_t>(_channel)));
+
+		_lastcheckedat = std::chrono::seconds(config->get_integer(ST_CFG_LASTCHECKEDAT, _lastcheckedat.count()));
 	}
 }
 
 void streamfx::updater::save()
 {
+	// Only marks the configuration as changed, the actual write happens later on the configuration's own thread.
 	if (auto config = streamfx::configuration::instance(); config) {
-		auto dataptr = config->get();
-
-		obs_data_set_bool(dataptr.get(), ST_CFG_GDPR, _gdpr);
-		obs_data_set_bool(dataptr.get(), ST_CFG_AUTOMATION, _automation);
-		obs_data_set_int(dataptr.get(), ST_CFG_CHANNEL, static_cast<long long>(_channel));
-		obs_data_set_int(dataptr.get(), ST_CFG_LASTCHECKEDAT, static_cast<long long>(_lastcheckedat.count()));
+		config->set_bool(ST_CFG_GDPR, _gdpr);
+		config->set_bool(ST_CFG_AUTOMATION, _automation);
+		config->set_integer(ST_CFG_CHANNEL, static_cast<int64_t>(_channel));
+		config->set_integer(ST_CFG_LASTCHECKEDAT, static_cast<int64_t>(_lastcheckedat.count()));
 	}
 }
 
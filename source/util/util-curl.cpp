@@ -19,7 +19,24 @@
 // SOFTWARE.
 
 #include "util-curl.hpp"
+#include <chrono>
 #include <sstream>
+#include "common.hpp"
+
+#define LOCAL_PREFIX "<util::curl> "
+
+// curl_multi_poll and curl_multi_wakeup were added in libcurl 7.68.0.
+#if LIBCURL_VERSION_NUM >= 0x074400
+#define ST_CURL_MULTI_POLL
+#endif
+
+#ifdef ST_CURL_MULTI_POLL
+// How long the client waits for socket activity before checking for shutdown.
+#define WAIT_INTERVAL_MS 1000
+#else
+// Without curl_multi_wakeup, new requests and shutdown are only noticed once the wait ends, so keep it short.
+#define WAIT_INTERVAL_MS 50
+#endif
 
 int32_t util::curl::debug_helper(CURL* handle, curl_infotype type, char* data, size_t size, util::curl* self)
 {
@@ -83,6 +100,15 @@ size_t util::curl::write_helper(void* ptr, size_t size, size_t count, util::curl
 	}
 }
 
+size_t util::curl::header_helper(void* ptr, size_t size, size_t count, util::curl* self)
+{
+	if (self->_header_callback) {
+		return self->_header_callback(ptr, size, count);
+	} else {
+		return size * count;
+	}
+}
+
 int32_t util::curl::xferinfo_callback(util::curl* self, curl_off_t dlt, curl_off_t dln, curl_off_t ult, curl_off_t uln)
 {
 	if (self->_xferinfo_callback) {
@@ -93,11 +119,15 @@ int32_t util::curl::xferinfo_callback(util::curl* self, curl_off_t dlt, curl_off
 	}
 }
 
-util::curl::curl() : _curl(), _read_callback(), _write_callback(), _headers()
+util::curl::curl()
+	: _curl(), _share(util::curl_share::instance()), _read_callback(), _write_callback(), _header_callback(),
+	  _headers(), _header_list(nullptr), _headers_changed(false)
 {
 	_curl = curl_easy_init();
+	set_option(CURLOPT_SHARE, _share->get());
 	set_read_callback(nullptr);
 	set_write_callback(nullptr);
+	set_header_callback(nullptr);
 	set_xferinfo_callback(nullptr);
 	set_debug_callback(nullptr);
 
@@ -115,71 +145,75 @@ util::curl::curl() : _curl(), _read_callback(), _write_callback(), _headers()
 util::curl::~curl()
 {
 	curl_easy_cleanup(_curl);
+	curl_slist_free_all(_header_list);
 }
 
 void util::curl::clear_headers()
 {
 	_headers.clear();
+	_headers_changed = true;
 }
 
 void util::curl::clear_header(std::string header)
 {
 	_headers.erase(header);
+	_headers_changed = true;
 }
 
 void util::curl::set_header(std::string header, std::string value)
 {
 	_headers.insert_or_assign(header, value);
+	_headers_changed = true;
 }
 
-size_t perform_get_kv_size(std::string a, std::string b)
+CURLcode util::curl::prepare()
 {
-	return a.size() + 2 + b.size() + 1;
-};
+	if (!_headers_changed) {
+		return CURLE_OK;
+	}
 
-CURLcode util::curl::perform()
-{
-	std::vector<char>  buffer;
+	// Only rebuild the header list if the headers actually changed since the last request.
 	struct curl_slist* headers = nullptr;
+	std::string        line;
+	for (auto& kv : _headers) {
+		line.clear();
+		line.reserve(kv.first.size() + 2 + kv.second.size());
+		line.append(kv.first).append(": ").append(kv.second);
 
-	if (_headers.size() > 0) {
-		// Calculate full buffer size.
-		{
-			size_t buffer_size = 0;
-			for (auto kv : _headers) {
-				buffer_size += perform_get_kv_size(kv.first, kv.second);
-			}
-			buffer.resize(buffer_size * 2);
-		}
-		// Create HTTP Headers.
-		{
-			size_t buffer_offset = 0;
-			for (auto kv : _headers) {
-				size_t size = perform_get_kv_size(kv.first, kv.second);
-
-				snprintf(&buffer.at(buffer_offset), size, "%s: %s", kv.first.c_str(), kv.second.c_str());
-
-				headers = curl_slist_append(headers, &buffer.at(buffer_offset));
-
-				buffer_offset += size;
-			}
+		if (struct curl_slist* next = curl_slist_append(headers, line.c_str()); next != nullptr) {
+			headers = next;
+		} else {
+			curl_slist_free_all(headers);
+			return CURLE_OUT_OF_MEMORY;
 		}
-		set_option<struct curl_slist*>(CURLOPT_HTTPHEADER, headers);
 	}
 
-	CURLcode res = curl_easy_perform(_curl);
-
-	if (headers) {
-		set_option<struct curl_slist*>(CURLOPT_HTTPHEADER, nullptr);
+	if (CURLcode res = set_option<struct curl_slist*>(CURLOPT_HTTPHEADER, headers); res != CURLE_OK) {
 		curl_slist_free_all(headers);
+		return res;
 	}
+	curl_slist_free_all(_header_list);
+	_header_list     = headers;
+	_headers_changed = false;
+
+	return CURLE_OK;
+}
 
-	return res;
+CURLcode util::curl::perform()
+{
+	if (CURLcode res = prepare(); res != CURLE_OK) {
+		return res;
+	}
+	return curl_easy_perform(_curl);
 }
 
 void util::curl::reset()
 {
 	curl_easy_reset(_curl);
+
+	// Resetting drops every option, including the shared cache and the header list.
+	set_option(CURLOPT_SHARE, _share->get());
+	_headers_changed = true;
 }
 
 CURLcode util::curl::set_read_callback(curl_io_callback_t cb)
@@ -198,6 +232,14 @@ CURLcode util::curl::set_write_callback(curl_io_callback_t cb)
 	return curl_easy_setopt(_curl, CURLOPT_WRITEFUNCTION, &write_helper);
 }
 
+CURLcode util::curl::set_header_callback(curl_io_callback_t cb)
+{
+	_header_callback = cb;
+	if (CURLcode res = curl_easy_setopt(_curl, CURLOPT_HEADERDATA, this); res != CURLE_OK)
+		return res;
+	return curl_easy_setopt(_curl, CURLOPT_HEADERFUNCTION, &header_helper);
+}
+
 CURLcode util::curl::set_xferinfo_callback(curl_xferinfo_callback_t cb)
 {
 	_xferinfo_callback = cb;
@@ -213,3 +255,201 @@ CURLcode util::curl::set_debug_callback(curl_debug_callback_t cb)
 		return res;
 	return curl_easy_setopt(_curl, CURLOPT_DEBUGFUNCTION, &debug_helper);
 }
+
+void util::curl_share::lock_helper(CURL*, curl_lock_data data, curl_lock_access, util::curl_share* self)
+{
+	self->_locks[data].lock();
+}
+
+void util::curl_share::unlock_helper(CURL*, curl_lock_data data, util::curl_share* self)
+{
+	self->_locks[data].unlock();
+}
+
+util::curl_share::curl_share() : _share(), _locks()
+{
+	_share = curl_share_init();
+	if (!_share) {
+		throw std::runtime_error("Failed to create shared cache.");
+	}
+
+	curl_share_setopt(_share, CURLSHOPT_USERDATA, this);
+	curl_share_setopt(_share, CURLSHOPT_LOCKFUNC, &lock_helper);
+	curl_share_setopt(_share, CURLSHOPT_UNLOCKFUNC, &unlock_helper);
+	curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+	curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+	if (CURLSHcode res = curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT); res != CURLSHE_OK) {
+		// Older versions of libcurl can't share connections, which only costs us some reconnects.
+		DLOG_DEBUG(LOCAL_PREFIX "Connection sharing is unavailable: %s", curl_share_strerror(res));
+	}
+}
+
+util::curl_share::~curl_share()
+{
+	curl_share_cleanup(_share);
+}
+
+CURLSH* util::curl_share::get()
+{
+	return _share;
+}
+
+std::shared_ptr<util::curl_share> util::curl_share::instance()
+{
+	static std::mutex                      lock;
+	static std::weak_ptr<util::curl_share> weak;
+
+	std::lock_guard<std::mutex>       lg(lock);
+	std::shared_ptr<util::curl_share> ptr = weak.lock();
+	if (!ptr) {
+		ptr  = std::make_shared<util::curl_share>();
+		weak = ptr;
+	}
+	return ptr;
+}
+
+util::curl_client::curl_client()
+	: _multi(), _share(util::curl_share::instance()), _lock(), _queue(), _active(), _stop(false), _worker()
+{
+	_multi = curl_multi_init();
+	if (!_multi) {
+		throw std::runtime_error("Failed to create multi handle.");
+	}
+
+	_worker = std::thread(std::bind(&util::curl_client::work, this));
+}
+
+util::curl_client::~curl_client()
+{
+	_stop = true;
+#ifdef ST_CURL_MULTI_POLL
+	curl_multi_wakeup(_multi);
+#endif
+	if (_worker.joinable()) {
+		_worker.join();
+	}
+
+	// Fail anything that did not complete in time.
+	std::lock_guard<std::mutex> lg(_lock);
+	for (auto& kv : _active) {
+		curl_multi_remove_handle(_multi, kv.first);
+		kv.second.promise.set_value(CURLE_ABORTED_BY_CALLBACK);
+	}
+	_active.clear();
+	for (auto& request : _queue) {
+		request.promise.set_value(CURLE_ABORTED_BY_CALLBACK);
+	}
+	_queue.clear();
+
+	curl_multi_cleanup(_multi);
+}
+
+std::future<CURLcode> util::curl_client::perform(std::shared_ptr<util::curl> handle)
+{
+	request_t             request{handle, std::promise<CURLcode>()};
+	std::future<CURLcode> future = request.promise.get_future();
+
+	if (CURLcode res = handle->prepare(); res != CURLE_OK) {
+		request.promise.set_value(res);
+		return future;
+	}
+
+	{
+		std::lock_guard<std::mutex> lg(_lock);
+		_queue.push_back(std::move(request));
+	}
+#ifdef ST_CURL_MULTI_POLL
+	curl_multi_wakeup(_multi);
+#endif
+
+	return future;
+}
+
+void util::curl_client::work()
+{
+	while (!_stop) {
+		start_queued();
+
+		int running = 0;
+		if (CURLMcode res = curl_multi_perform(_multi, &running); res != CURLM_OK) {
+			DLOG_ERROR(LOCAL_PREFIX "Driving requests failed: %s", curl_multi_strerror(res));
+		}
+
+		finish_done();
+
+#ifdef ST_CURL_MULTI_POLL
+		if (CURLMcode res = curl_multi_poll(_multi, nullptr, 0, WAIT_INTERVAL_MS, nullptr); res != CURLM_OK) {
+			DLOG_ERROR(LOCAL_PREFIX "Waiting for requests failed: %s", curl_multi_strerror(res));
+		}
+#else
+		// curl_multi_wait returns immediately if there is nothing to wait on, so sleep instead of spinning.
+		int fds = 0;
+		if (CURLMcode res = curl_multi_wait(_multi, nullptr, 0, WAIT_INTERVAL_MS, &fds); res != CURLM_OK) {
+			DLOG_ERROR(LOCAL_PREFIX "Waiting for requests failed: %s", curl_multi_strerror(res));
+		}
+		if (fds == 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_INTERVAL_MS));
+		}
+#endif
+	}
+}
+
+void util::curl_client::start_queued()
+{
+	std::lock_guard<std::mutex> lg(_lock);
+	while (!_queue.empty()) {
+		request_t request = std::move(_queue.front());
+		_queue.pop_front();
+
+		CURL* easy = request.handle->_curl;
+		if (CURLMcode res = curl_multi_add_handle(_multi, easy); res != CURLM_OK) {
+			DLOG_ERROR(LOCAL_PREFIX "Starting request failed: %s", curl_multi_strerror(res));
+			request.promise.set_value(CURLE_FAILED_INIT);
+			continue;
+		}
+		_active.emplace(easy, std::move(request));
+	}
+}
+
+void util::curl_client::finish_done()
+{
+	int remaining = 0;
+	while (CURLMsg* msg = curl_multi_info_read(_multi, &remaining)) {
+		if (msg->msg != CURLMSG_DONE) {
+			continue;
+		}
+
+		CURL*    easy = msg->easy_handle;
+		CURLcode code = msg->data.result;
+		curl_multi_remove_handle(_multi, easy);
+
+		request_t request;
+		{
+			std::lock_guard<std::mutex> lg(_lock);
+			auto                        kv = _active.find(easy);
+			if (kv == _active.end()) {
+				continue;
+			}
+			request = std::move(kv->second);
+			_active.erase(kv);
+		}
+		request.promise.set_value(code);
+	}
+}
+
+static std::shared_ptr<util::curl_client> curl_client_instance;
+
+void util::curl_client::initialize()
+{
+	curl_client_instance = std::make_shared<util::curl_client>();
+}
+
+void util::curl_client::finalize()
+{
+	curl_client_instance.reset();
+}
+
+std::shared_ptr<util::curl_client> util::curl_client::get()
+{
+	return curl_client_instance;
+}
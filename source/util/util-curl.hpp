@@ -19,11 +19,17 @@
 // SOFTWARE.
 
 #pragma once
+#include <atomic>
 #include <cinttypes>
 #include <cstring>
 #include <functional>
+#include <future>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 extern "C" {
@@ -38,19 +44,33 @@ namespace util {
 	typedef std::function<int32_t(uint64_t, uint64_t, uint64_t, uint64_t)> curl_xferinfo_callback_t;
 	typedef std::function<void(CURL*, curl_infotype, char*, size_t)>       curl_debug_callback_t;
 
+	class curl_share;
+	class curl_client;
+
 	class curl {
 		CURL*                              _curl;
+		std::shared_ptr<util::curl_share>  _share;
 		curl_io_callback_t                 _read_callback;
 		curl_io_callback_t                 _write_callback;
+		curl_io_callback_t                 _header_callback;
 		curl_xferinfo_callback_t           _xferinfo_callback;
 		curl_debug_callback_t              _debug_callback;
 		std::map<std::string, std::string> _headers;
+		struct curl_slist*                 _header_list;
+		bool                               _headers_changed;
 
 		static int32_t debug_helper(CURL* handle, curl_infotype type, char* data, size_t size, util::curl* userptr);
 		static size_t  read_helper(void*, size_t, size_t, util::curl*);
 		static size_t  write_helper(void*, size_t, size_t, util::curl*);
+		static size_t  header_helper(void*, size_t, size_t, util::curl*);
 		static int32_t xferinfo_callback(util::curl*, curl_off_t, curl_off_t, curl_off_t, curl_off_t);
 
+		/** Apply state that is only updated on demand, like the header list.
+		 */
+		CURLcode prepare();
+
+		friend class util::curl_client;
+
 		public:
 		curl();
 		~curl();
@@ -122,8 +142,71 @@ namespace util {
 
 		CURLcode set_write_callback(curl_io_callback_t cb);
 
+		CURLcode set_header_callback(curl_io_callback_t cb);
+
 		CURLcode set_xferinfo_callback(curl_xferinfo_callback_t cb);
 
 		CURLcode set_debug_callback(curl_debug_callback_t cb);
 	};
+
+	/** Connection, DNS and TLS session cache shared by all util::curl instances.
+	 */
+	class curl_share {
+		CURLSH*    _share;
+		std::mutex _locks[CURL_LOCK_DATA_LAST];
+
+		static void lock_helper(CURL*, curl_lock_data, curl_lock_access, util::curl_share*);
+		static void unlock_helper(CURL*, curl_lock_data, util::curl_share*);
+
+		public:
+		curl_share();
+		~curl_share();
+
+		CURLSH* get();
+
+		public: // Singleton
+		static std::shared_ptr<util::curl_share> instance();
+	};
+
+	/** Performs util::curl requests concurrently on a single background thread.
+	 *
+	 * Requests are driven by a curl multi handle, so any number of them can be in flight without blocking a thread
+	 * each. The util::curl must stay alive and unchanged until the returned future is ready.
+	 */
+	class curl_client {
+		struct request_t {
+			std::shared_ptr<util::curl> handle;
+			std::promise<CURLcode>      promise;
+		};
+
+		CURLM*                            _multi;
+		std::shared_ptr<util::curl_share> _share;
+
+		std::mutex                 _lock;
+		std::list<request_t>       _queue;
+		std::map<CURL*, request_t> _active;
+
+		std::atomic<bool> _stop;
+		std::thread       _worker;
+
+		public:
+		curl_client();
+		~curl_client();
+
+		std::future<CURLcode> perform(std::shared_ptr<util::curl> handle);
+
+		private:
+		void work();
+
+		void start_queued();
+
+		void finish_done();
+
+		public: // Singleton
+		static void initialize();
+
+		static void finalize();
+
+		static std::shared_ptr<util::curl_client> get();
+	};
 } // namespace util
@@ -19,25 +19,79 @@
 
 #pragma once
 #include "common.hpp"
+#include <algorithm>
+#include <atomic>
 #include <functional>
-#include <list>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace util {
+	/** Event with any number of listeners.
+	 *
+	 * Listeners are kept in an immutable array which is replaced as a whole whenever a listener is added or removed,
+	 * so calling the event never takes a lock or allocates memory. Replaced arrays are freed once no call is using
+	 * them anymore.
+	 */
 	template<typename... _args>
 	class event {
-		std::list<std::function<void(_args...)>> _listeners;
-		std::recursive_mutex                     _lock;
+		public:
+		typedef std::function<void(_args...)> listener_t;
+		typedef uint64_t                      handle_t;
+
+		private:
+		typedef std::vector<std::pair<handle_t, listener_t>> listeners_t;
+
+		std::atomic<listeners_t*>                 _listeners;
+		std::atomic<std::size_t>                  _readers;
+		std::atomic<bool>                         _dirty;
+		std::mutex                                _lock;
+		std::unique_ptr<listeners_t>              _current;
+		std::vector<std::unique_ptr<listeners_t>> _retired;
+		handle_t                                  _next_handle;
 
 		std::function<void()> _cb_fill;
 		std::function<void()> _cb_clear;
 
+		// Replace the listener array, must be called with _lock held.
+		void publish(std::unique_ptr<listeners_t> listeners)
+		{
+			if (listeners && listeners->empty()) {
+				listeners.reset();
+			}
+
+			_listeners.store(listeners.get());
+			if (_current) {
+				_retired.push_back(std::move(_current));
+				_dirty.store(true);
+			}
+			_current = std::move(listeners);
+			reclaim();
+		}
+
+		// Free retired listener arrays if no call is using them, must be called with _lock held.
+		void reclaim()
+		{
+			if (_readers.load() == 0) {
+				_retired.clear();
+				_dirty.store(false);
+			}
+		}
+
 		public /* constructor */:
-		event() : _listeners(), _lock(), _cb_fill(), _cb_clear() {}
+		event()
+			: _listeners(nullptr), _readers(0), _dirty(false), _lock(), _current(), _retired(), _next_handle(1),
+			  _cb_fill(), _cb_clear()
+		{}
 		virtual ~event()
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
-			this->clear();
+			std::lock_guard<std::mutex> lg(_lock);
+			if (_current && _cb_clear) {
+				_cb_clear();
+			}
+			_listeners.store(nullptr);
+			_current.reset();
+			_retired.clear();
 		}
 
 		/* Copy Constructor */
@@ -46,12 +100,7 @@ namespace util {
 		/* Move Constructor */
 		event(event<_args...>&& other) : event()
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
-			std::lock_guard<std::recursive_mutex> lgo(other._lock);
-
-			_listeners.swap(other._listeners);
-			_cb_fill.swap(other._cb_fill);
-			_cb_clear.swap(other._cb_clear);
+			*this = std::move(other);
 		}
 
 		public /* operators */:
@@ -59,15 +108,40 @@ namespace util {
 		/* Copy Operator */
 		event<_args...>& operator=(const event<_args...>&) = delete;
 
-		/* Move Operator */
+		/* Move Operator
+		 *
+		 * Only the listeners move, the fill and clear callbacks stay with their event and are called as if the
+		 * listeners had been added or removed one by one.
+		 */
 		event<_args...>& operator=(event<_args...>&& other)
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
-			std::lock_guard<std::recursive_mutex> lgo(other._lock);
+			if (this == &other) {
+				return *this;
+			}
+
+			std::lock_guard<std::mutex> lg(_lock);
+			std::lock_guard<std::mutex> lgo(other._lock);
+
+			bool had_mine   = static_cast<bool>(_current);
+			bool had_theirs = static_cast<bool>(other._current);
 
-			_listeners.swap(other._listeners);
-			_cb_fill.swap(other._cb_fill);
-			_cb_clear.swap(other._cb_clear);
+			std::unique_ptr<listeners_t> mine   = std::move(_current);
+			std::unique_ptr<listeners_t> theirs = std::move(other._current);
+			other.publish(std::move(mine));
+			publish(std::move(theirs));
+			_next_handle = other._next_handle = std::max(_next_handle, other._next_handle);
+
+			if (had_mine && !had_theirs) {
+				if (_cb_clear)
+					_cb_clear();
+				if (other._cb_fill)
+					other._cb_fill();
+			} else if (!had_mine && had_theirs) {
+				if (other._cb_clear)
+					other._cb_clear();
+				if (_cb_fill)
+					_cb_fill();
+			}
 
 			return *this;
 		}
@@ -82,9 +156,29 @@ namespace util {
 		template<typename... _largs>
 		inline void call(_args... args)
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
-			for (auto& l : _listeners) {
-				l(args...);
+			struct reader {
+				event<_args...>* self;
+
+				reader(event<_args...>* self) : self(self)
+				{
+					self->_readers.fetch_add(1);
+				}
+				~reader()
+				{
+					// The last call to leave frees what was replaced while it was running, unless someone else is.
+					if ((self->_readers.fetch_sub(1) == 1) && self->_dirty.load()) {
+						std::unique_lock<std::mutex> ul(self->_lock, std::try_to_lock);
+						if (ul.owns_lock()) {
+							self->reclaim();
+						}
+					}
+				}
+			} guard(this);
+
+			if (listeners_t* listeners = _listeners.load(); listeners) {
+				for (auto& l : *listeners) {
+					l.second(args...);
+				}
 			}
 		}
 
@@ -92,39 +186,60 @@ namespace util {
 
 		/** Add a new listener to the event.
 		 * @param listener A listener bound with std::bind or a std::function.
+		 * @return handle_t Handle with which the listener can be removed again.
 		 */
-		inline void add(std::function<void(_args...)> listener)
+		inline handle_t add(listener_t listener)
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
-			if (_listeners.size() == 0) {
+			std::lock_guard<std::mutex> lg(_lock);
+			if (!_current) {
 				if (_cb_fill) {
 					_cb_fill();
 				}
 			}
-			_listeners.push_back(listener);
+
+			auto     listeners = _current ? std::make_unique<listeners_t>(*_current) : std::make_unique<listeners_t>();
+			handle_t handle    = _next_handle++;
+			listeners->emplace_back(handle, listener);
+			publish(std::move(listeners));
+			return handle;
 		}
-		inline event<_args...>& operator+=(std::function<void(_args...)> listener)
+		inline event<_args...>& operator+=(listener_t listener)
 		{
 			this->add(listener);
 			return *this;
 		}
 
 		/** Remove an existing listener from the event.
-		 * @param listener A listener bound with std::bind or a std::function.
+		 * @param handle The handle returned when the listener was added.
 		 */
-		inline void remove(std::function<void(_args...)> listener)
+		inline void remove(handle_t handle)
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
-			_listeners.remove(listener);
-			if (_listeners.size() == 0) {
+			std::lock_guard<std::mutex> lg(_lock);
+			if (!_current) {
+				return;
+			}
+
+			auto listeners = std::make_unique<listeners_t>();
+			listeners->reserve(_current->size());
+			for (auto& l : *_current) {
+				if (l.first != handle) {
+					listeners->push_back(l);
+				}
+			}
+			if (listeners->size() == _current->size()) {
+				return;
+			}
+
+			publish(std::move(listeners));
+			if (!_current) {
 				if (_cb_clear) {
 					_cb_clear();
 				}
 			}
 		}
-		inline event<_args...>& operator-=(std::function<void(_args...)> listener)
+		inline event<_args...>& operator-=(handle_t handle)
 		{
-			this->remove(listener);
+			this->remove(handle);
 			return *this;
 		}
 
@@ -133,8 +248,7 @@ namespace util {
 		 */
 		inline bool empty()
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
-			return _listeners.empty();
+			return _listeners.load() == nullptr;
 		}
 		inline operator bool()
 		{
@@ -145,8 +259,12 @@ namespace util {
 		 */
 		inline void clear()
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
-			_listeners.clear();
+			std::lock_guard<std::mutex> lg(_lock);
+			if (!_current) {
+				return;
+			}
+
+			publish(nullptr);
 			if (_cb_clear) {
 				_cb_clear();
 			}
@@ -161,13 +279,13 @@ namespace util {
 
 		void set_listen_callback(std::function<void()> cb)
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
+			std::lock_guard<std::mutex> lg(_lock);
 			this->_cb_fill = cb;
 		}
 
 		void set_silence_callback(std::function<void()> cb)
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
+			std::lock_guard<std::mutex> lg(_lock);
 			this->_cb_clear = cb;
 		}
 	};
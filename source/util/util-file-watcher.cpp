@@ -0,0 +1,292 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "util-file-watcher.hpp"
+#include "common.hpp"
+#include <chrono>
+#include <set>
+#include <vector>
+
+#if defined(__linux__)
+#define ST_INOTIFY
+#endif
+
+#if defined(ST_INOTIFY)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#define LOCAL_PREFIX "<util::file_watcher> "
+
+// How long the worker waits for events before checking for shutdown.
+#define WAIT_INTERVAL std::chrono::milliseconds(250)
+
+// Files without an inotify watch are checked every N wait intervals.
+#define POLL_INTERVALS 2
+
+// Expired subscriptions are cleaned up every N wait intervals.
+#define PRUNE_INTERVALS 8
+
+static std::shared_ptr<util::file_watcher> file_watcher_instance;
+
+util::file_watcher::file_watcher()
+	: _lock(), _files(), _directories(), _descriptors(), _inotify(-1), _stop(false), _worker()
+{
+#if defined(ST_INOTIFY)
+	_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (_inotify < 0) {
+		DLOG_WARNING(LOCAL_PREFIX "inotify is unavailable, falling back to polling.");
+	}
+#endif
+
+	_worker = std::thread(std::bind(&util::file_watcher::work, this));
+}
+
+util::file_watcher::~file_watcher()
+{
+	_stop = true;
+	if (_worker.joinable()) {
+		_worker.join();
+	}
+
+#if defined(ST_INOTIFY)
+	if (_inotify >= 0) {
+		close(_inotify);
+		_inotify = -1;
+	}
+#endif
+}
+
+util::file_watcher::subscription_t util::file_watcher::watch(std::filesystem::path file, callback_t callback)
+{
+	std::error_code       ec;
+	std::filesystem::path path = std::filesystem::absolute(file, ec).lexically_normal();
+	if (ec) {
+		path = file.lexically_normal();
+	}
+
+	auto subscription = std::make_shared<callback_t>(callback);
+
+	std::unique_lock<std::mutex> lock(_lock);
+	auto                         kv = _files.find(path);
+	if (kv == _files.end()) {
+		file_state state;
+		state.time = std::filesystem::last_write_time(path, ec);
+		state.size = std::filesystem::file_size(path, ec);
+		kv         = _files.emplace(path, state).first;
+
+#if defined(ST_INOTIFY)
+		// Watch the directory instead of the file, so that replacing the file does not silently end the watch.
+		auto directory = path.parent_path();
+		if ((_inotify >= 0) && (_directories.count(directory) == 0)) {
+			int wd = inotify_add_watch(_inotify, directory.c_str(),
+									   IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_ATTRIB);
+			if (wd >= 0) {
+				_directories.emplace(directory, wd);
+				_descriptors.emplace(wd, directory);
+			}
+		}
+#endif
+	}
+	kv->second.listeners.push_back(subscription);
+
+	return subscription;
+}
+
+void util::file_watcher::work()
+{
+	std::size_t interval = 0;
+	while (!_stop) {
+#if defined(ST_INOTIFY)
+		if (_inotify >= 0) {
+			pollfd pfd = {_inotify, POLLIN, 0};
+			if (poll(&pfd, 1, static_cast<int>(WAIT_INTERVAL.count())) > 0) {
+				read_events();
+			}
+		} else {
+			std::this_thread::sleep_for(WAIT_INTERVAL);
+		}
+#else
+		std::this_thread::sleep_for(WAIT_INTERVAL);
+#endif
+
+		interval++;
+		if ((interval % POLL_INTERVALS) == 0) {
+			poll_files();
+		}
+		if ((interval % PRUNE_INTERVALS) == 0) {
+			prune();
+		}
+	}
+}
+
+void util::file_watcher::poll_files()
+{
+	// Only files which are not covered by a directory watch need to be polled.
+	std::vector<std::filesystem::path> files;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		for (auto& kv : _files) {
+			if (_directories.count(kv.first.parent_path()) == 0) {
+				files.push_back(kv.first);
+			}
+		}
+	}
+
+	for (auto& file : files) {
+		std::error_code ec;
+		auto            time = std::filesystem::last_write_time(file, ec);
+		auto            size = std::filesystem::file_size(file, ec);
+
+		bool changed = false;
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+			if (auto kv = _files.find(file); kv != _files.end()) {
+				if ((kv->second.time != time) || (kv->second.size != size)) {
+					kv->second.time = time;
+					kv->second.size = size;
+					changed         = true;
+				}
+			}
+		}
+
+		if (changed) {
+			notify(file);
+		}
+	}
+}
+
+void util::file_watcher::read_events()
+{
+#if defined(ST_INOTIFY)
+	std::set<std::filesystem::path> changed;
+	alignas(inotify_event) char     buffer[4096];
+
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		for (ssize_t length = read(_inotify, buffer, sizeof(buffer)); length > 0;
+			 length         = read(_inotify, buffer, sizeof(buffer))) {
+			for (char* ptr = buffer; ptr < (buffer + length);) {
+				auto event = reinterpret_cast<inotify_event*>(ptr);
+				ptr += sizeof(inotify_event) + event->len;
+
+				if (event->mask & IN_Q_OVERFLOW) {
+					// Events were lost, so any file could have changed.
+					for (auto& kv : _files) {
+						changed.insert(kv.first);
+					}
+					continue;
+				}
+
+				auto directory = _descriptors.find(event->wd);
+				if (directory == _descriptors.end()) {
+					continue;
+				}
+
+				if (event->mask & IN_IGNORED) {
+					// The directory itself went away, fall back to polling for its files.
+					_directories.erase(directory->second);
+					_descriptors.erase(directory);
+					continue;
+				}
+
+				if (event->len > 0) {
+					auto file = directory->second / event->name;
+					if (_files.count(file) != 0) {
+						changed.insert(file);
+					}
+				}
+			}
+		}
+	}
+
+	for (auto& file : changed) {
+		notify(file);
+	}
+#endif
+}
+
+void util::file_watcher::notify(const std::filesystem::path& file)
+{
+	std::list<std::shared_ptr<callback_t>> listeners;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		if (auto kv = _files.find(file); kv != _files.end()) {
+			for (auto& listener : kv->second.listeners) {
+				if (auto callback = listener.lock(); callback) {
+					listeners.push_back(callback);
+				}
+			}
+		}
+	}
+
+	for (auto& callback : listeners) {
+		try {
+			(*callback)(file);
+		} catch (const std::exception& ex) {
+			DLOG_WARNING(LOCAL_PREFIX "Callback for '%s' threw exception: %s", file.u8string().c_str(), ex.what());
+		} catch (...) {
+			DLOG_WARNING(LOCAL_PREFIX "Callback for '%s' threw an unknown exception.", file.u8string().c_str());
+		}
+	}
+}
+
+void util::file_watcher::prune()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+
+	std::set<std::filesystem::path> directories;
+	for (auto kv = _files.begin(); kv != _files.end();) {
+		kv->second.listeners.remove_if([](const std::weak_ptr<callback_t>& v) { return v.expired(); });
+		if (kv->second.listeners.empty()) {
+			kv = _files.erase(kv);
+		} else {
+			directories.insert(kv->first.parent_path());
+			kv++;
+		}
+	}
+
+	for (auto kv = _directories.begin(); kv != _directories.end();) {
+		if (directories.count(kv->first) == 0) {
+#if defined(ST_INOTIFY)
+			inotify_rm_watch(_inotify, kv->second);
+#endif
+			_descriptors.erase(kv->second);
+			kv = _directories.erase(kv);
+		} else {
+			kv++;
+		}
+	}
+}
+
+void util::file_watcher::initialize()
+{
+	file_watcher_instance = std::make_shared<util::file_watcher>();
+}
+
+void util::file_watcher::finalize()
+{
+	file_watcher_instance.reset();
+}
+
+std::shared_ptr<util::file_watcher> util::file_watcher::get()
+{
+	return file_watcher_instance;
+}
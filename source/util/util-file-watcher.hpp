@@ -0,0 +1,87 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2020 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace util {
+	/** Shared watcher for file changes.
+	 *
+	 * Any number of subscribers can watch the same file, while the file itself is only watched once. On Linux this
+	 * uses inotify on the containing directory, so files replaced by a rename are detected too. Everywhere else, or if
+	 * inotify is unavailable, all watched files are polled from a single thread instead.
+	 *
+	 * Callbacks are invoked on the watcher thread and should only schedule work.
+	 */
+	class file_watcher {
+		public:
+		typedef std::function<void(const std::filesystem::path&)> callback_t;
+		typedef std::shared_ptr<callback_t> subscription_t;
+
+		private:
+		struct file_state {
+			std::filesystem::file_time_type      time;
+			uintmax_t                            size;
+			std::list<std::weak_ptr<callback_t>> listeners;
+		};
+
+		std::mutex                                  _lock;
+		std::map<std::filesystem::path, file_state> _files;
+		std::map<std::filesystem::path, int>        _directories;
+		std::map<int, std::filesystem::path>        _descriptors;
+		int                                         _inotify;
+		std::atomic_bool                            _stop;
+		std::thread                                 _worker;
+
+		public:
+		file_watcher();
+		~file_watcher();
+
+		/** Watch a file for changes.
+		 *
+		 * The returned subscription keeps the callback alive. Destroying it stops notifications for this subscriber.
+		 */
+		subscription_t watch(std::filesystem::path file, callback_t callback);
+
+		private:
+		void work();
+
+		void poll_files();
+
+		void read_events();
+
+		void notify(const std::filesystem::path& file);
+
+		void prune();
+
+		public: // Singleton
+		static void initialize();
+
+		static void finalize();
+
+		static std::shared_ptr<util::file_watcher> get();
+	};
+} // namespace util